@@ -0,0 +1,164 @@
+// Decoder throughput: native CAT048/034 decoders against the tshark EK path.
+//
+//   asterix_bench [records] [--tshark]
+//
+// Builds a synthetic CAT048 stream (plus a CAT034 north marker per datagram),
+// decodes it in-process, then optionally pipes the same traffic through
+// "tshark -T ek" and reports records/second for each.
+#include "AsterixDecoder.hpp"
+#include "PcapWriter.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static constexpr uint16_t BENCH_PORT = 8600;
+static constexpr int RECORDS_PER_BLOCK = 20;
+
+static void put16(std::vector<uint8_t>& b, uint32_t v) { b.push_back(uint8_t(v >> 8)); b.push_back(uint8_t(v)); }
+static void put24(std::vector<uint8_t>& b, uint32_t v) { b.push_back(uint8_t(v >> 16)); put16(b, v); }
+
+// A typical Mode S plot: I010 I140 I020 I040 I070 I090 I220 I240 I161 I042 I200 I170 I210
+static void appendCat048Record(std::vector<uint8_t>& b, uint32_t i) {
+    b.push_back(0xFD); b.push_back(0xDF); b.push_back(0x80);
+    b.push_back(25); b.push_back(1);                   // I010
+    put24(b, (43200 + i) * 128);                       // I140
+    b.push_back(0xA0);                                 // I020
+    put16(b, 40 * 256 + i % 256); put16(b, (i * 97) & 0xFFFF); // I040
+    put16(b, 01234);                                   // I070
+    put16(b, 350 * 4);                                 // I090
+    put24(b, 0x400000 + (i & 0xFFFF));                 // I220
+    static const uint8_t callsign[6] = {0x08, 0x73, 0x1C, 0x30, 0xC3, 0x0C};
+    b.insert(b.end(), callsign, callsign + 6);         // I240
+    put16(b, i & 0x0FFF);                              // I161
+    put16(b, 128 * 10); put16(b, 128 * 20);            // I042
+    put16(b, 0x0800); put16(b, 0x4000);                // I200
+    b.push_back(0x40);                                 // I170
+    b.push_back(16); b.push_back(16); b.push_back(8); b.push_back(32); // I210
+}
+
+static std::vector<std::vector<uint8_t>> buildDatagrams(size_t records) {
+    std::vector<std::vector<uint8_t>> out;
+    for (size_t done = 0; done < records;) {
+        std::vector<uint8_t> d = {34, 0, 11, 0xF0, 25, 1, 1};  // CAT034 north marker
+        put24(d, 43200 * 128);
+        d.push_back(0);
+
+        size_t start = d.size();
+        d.push_back(48); put16(d, 0);
+        for (int r = 0; r < RECORDS_PER_BLOCK && done < records; ++r, ++done) appendCat048Record(d, uint32_t(done));
+        size_t blockLen = d.size() - start;
+        d[start + 1] = uint8_t(blockLen >> 8);
+        d[start + 2] = uint8_t(blockLen);
+        out.push_back(std::move(d));
+    }
+    return out;
+}
+
+static double benchNative(const std::vector<std::vector<uint8_t>>& datagrams, size_t& records,
+                          const AsterixProjection* projection = nullptr, bool columnar = false) {
+    AsterixDecoder decoder;
+    if (projection) decoder.addProjection(*projection);
+    decoder.setColumnar048(columnar);
+    AsterixDecodeResult result;
+    records = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 10; ++pass) {
+        for (const auto& d : datagrams) {
+            result.clear();
+            decoder.decode(d.data(), d.size(), result);
+            records += result.cat048.size() + result.plots048.count + result.cat034.size();
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Table-driven walk only (no field decoding), for comparison with the specialised path
+static double benchGenericWalk(const std::vector<std::vector<uint8_t>>& datagrams, size_t& records) {
+    RecordItems items;
+    records = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < 10; ++pass) {
+        for (const auto& d : datagrams) {
+            const uint8_t* p = d.data();
+            const uint8_t* end = p + d.size();
+            while (end - p >= 3) {
+                const UapTable& uap = p[0] == 48 ? AsterixDecoder::uapCat048() : AsterixDecoder::uapCat034();
+                const uint8_t* blockEnd = p + ((p[1] << 8) | p[2]);
+                for (const uint8_t* rec = p + 3; rec && rec < blockEnd;) {
+                    rec = AsterixDecoder::walkRecord(uap, rec, blockEnd, items);
+                    if (rec) records++;
+                }
+                p = blockEnd;
+            }
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool writePcap(const std::string& path, const std::vector<std::vector<uint8_t>>& datagrams) {
+    std::string out;
+    PcapWriter::appendFileHeader(out, PcapWriter::LINKTYPE_RAW);
+    uint8_t pkt[65536];
+    for (const auto& d : datagrams) {
+        // IPv4 (no checksum) + UDP header so "-d udp.port==N,asterix" applies
+        uint32_t ipLen = 28 + uint32_t(d.size());
+        memset(pkt, 0, 28);
+        pkt[0] = 0x45; pkt[2] = uint8_t(ipLen >> 8); pkt[3] = uint8_t(ipLen);
+        pkt[8] = 64; pkt[9] = 17;
+        pkt[12] = 127; pkt[15] = 1; pkt[16] = 127; pkt[19] = 1;
+        pkt[22] = uint8_t(BENCH_PORT >> 8); pkt[23] = uint8_t(BENCH_PORT);
+        pkt[24] = uint8_t((ipLen - 20) >> 8); pkt[25] = uint8_t(ipLen - 20);
+        memcpy(pkt + 28, d.data(), d.size());
+        PcapWriter::appendRecord(out, 0, 0, pkt, ipLen, ipLen);
+    }
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    fclose(f);
+    return ok;
+}
+
+static double benchTshark(const std::vector<std::vector<uint8_t>>& datagrams) {
+    std::string path = "/tmp/asterix_bench.pcap";
+    if (!writePcap(path, datagrams)) return -1.0;
+    std::string cmd = "tshark -n -r " + path + " -d udp.port==" + std::to_string(BENCH_PORT) +
+                      ",asterix -T ek > /dev/null 2>&1";
+    auto start = std::chrono::steady_clock::now();
+    int rc = system(cmd.c_str());
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    remove(path.c_str());
+    return rc == 0 ? secs : -1.0;
+}
+
+int main(int argc, char** argv) {
+    size_t records = 200000;
+    bool tshark = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--tshark") == 0) tshark = true;
+        else records = strtoul(argv[i], nullptr, 10);
+    }
+
+    auto datagrams = buildDatagrams(records);
+    printf("%zu CAT048 records in %zu datagrams\n", records, datagrams.size());
+
+    size_t n = 0;
+    double secs = benchGenericWalk(datagrams, n);
+    printf("generic walk  : %12.0f records/s\n", n / secs);
+    secs = benchNative(datagrams, n);
+    printf("native decode : %12.0f records/s\n", n / secs);
+    AsterixProjection cot{"cot", C048_TRACK_NUMBER | C048_POLAR, C034_POSITION};
+    secs = benchNative(datagrams, n, &cot);
+    printf("  CoT fields  : %12.0f records/s\n", n / secs);
+    secs = benchNative(datagrams, n, &cot, true);
+    printf("  columns     : %12.0f records/s (%s)\n", n / secs, PlotColumns::kernel());
+
+    if (tshark) {
+        secs = benchTshark(datagrams);
+        if (secs < 0) printf("tshark -T ek  : failed (is tshark installed?)\n");
+        else printf("tshark -T ek  : %12.0f records/s\n", (records + datagrams.size()) / secs);
+    }
+    return 0;
+}
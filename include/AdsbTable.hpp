@@ -0,0 +1,48 @@
+#ifndef ADSB_TABLE_HPP
+#define ADSB_TABLE_HPP
+
+#include "ModeS.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Per-aircraft state (ADS-B, MLAT, Mode S Comm-B) keyed by the 24-bit ICAO
+// address. Flat open addressing with linear probing over a power-of-two
+// array: one multiply and usually one cache line per lookup, no allocation
+// per aircraft.
+class AdsbTable {
+public:
+    struct Entry {
+        uint32_t address = EMPTY;
+        char callsign[9] = {};    // Last I170 seen; reports without one reuse it
+        uint16_t mode3A = 0;
+        bool hasMode3A = false;
+        ModeSData modeS;          // Comm-B registers from CAT048/CAT020 I250
+        double modeSTime = 0.0;   // When a report last carried a current register
+        double lastSeen = 0.0;    // Caller's clock, seconds
+    };
+
+    explicit AdsbTable(size_t capacity = 4096);
+
+    // Entry for 'address', created if new. Stays valid until the next upsert/expire.
+    Entry& upsert(uint32_t address, double now);
+    const Entry* find(uint32_t address) const;
+
+    // Drop aircraft not seen for 'maxAge' seconds; returns how many went
+    size_t expire(double now, double maxAge);
+    size_t size() const { return m_count; }
+
+private:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFF;   // Not a 24-bit address
+
+    size_t slotOf(uint32_t address) const { return (address * 0x9E3779B1u) >> m_shift; }
+    void grow();
+    void erase(size_t slot);
+
+    std::vector<Entry> m_slots;
+    size_t m_mask = 0;
+    unsigned m_shift = 0;
+    size_t m_count = 0;
+};
+
+#endif
@@ -0,0 +1,527 @@
+#ifndef ASTERIX_DECODER_HPP
+#define ASTERIX_DECODER_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// --- UAP DESCRIPTION ---
+// How the length of a data item is determined on the wire
+enum class UapItemType : uint8_t {
+    Spare,      // FRN not used by this category
+    Fixed,      // 'len' octets
+    Extended,   // 'len' octets, then 'ext' octets while the FX bit (LSB) is set
+    Repetitive, // 1 octet REP, then REP * 'len' octets
+    Explicit,   // 1 octet total length (including itself)
+    Compound    // Primary subfield (FX-extended bitmap), then the present subfields
+};
+
+struct UapItem {
+    uint16_t id = 0;              // Data item number, e.g. 40 for I040
+    UapItemType type = UapItemType::Spare;
+    uint16_t len = 0;             // Fixed/first part length, or repetition size
+    uint8_t ext = 0;
+    const UapItem* sub = nullptr; // Compound subfields, in primary-subfield bit order
+    uint8_t subCount = 0;
+};
+
+struct UapTable {
+    uint8_t category;
+    const UapItem* items;         // Indexed by FRN - 1
+    uint8_t count;
+};
+
+// FSPEC allows up to 8 octets (7 FRNs each) in practice
+constexpr int ASTERIX_MAX_FRN = 56;
+
+// Location of one data item inside a record (no copy)
+struct ItemSlice {
+    const uint8_t* ptr = nullptr;
+    uint16_t len = 0;
+};
+
+// Result of walking one record's FSPEC: where each present item lives
+struct RecordItems {
+    uint64_t present = 0;         // Bit (FRN - 1) set when the item is in the record
+    ItemSlice items[ASTERIX_MAX_FRN];
+
+    bool has(int frn) const { return (present >> (frn - 1)) & 1ULL; }
+    const uint8_t* at(int frn) const { return items[frn - 1].ptr; }
+};
+
+// --- TYPED RECORDS ---
+// Typed items no consumer projected: located during decoding, parsed only by
+// AsterixDecoder::complete(). Offsets point into the datagram, so complete()
+// must run while the caller still holds it.
+struct LazyItems {
+    static constexpr int MAX_FRN = 32;
+    const uint8_t* base = nullptr; // Start of the record on the wire
+    uint32_t pending = 0;          // Field flags located but not parsed
+    uint32_t located = 0;          // Bit (FRN - 1) per item behind 'pending': several
+                                   // items can share one field flag (e.g. I071/I073)
+    uint16_t offset[MAX_FRN] = {}; // From 'base', indexed by FRN - 1
+};
+
+enum Cat048Field : uint32_t {
+    C048_DATA_SOURCE   = 1u << 0,  // I010
+    C048_TIME          = 1u << 1,  // I140
+    C048_REPORT_TYPE   = 1u << 2,  // I020
+    C048_POLAR         = 1u << 3,  // I040
+    C048_MODE3A        = 1u << 4,  // I070
+    C048_FLIGHT_LEVEL  = 1u << 5,  // I090
+    C048_ADDRESS       = 1u << 6,  // I220
+    C048_CALLSIGN      = 1u << 7,  // I240
+    C048_TRACK_NUMBER  = 1u << 8,  // I161
+    C048_CARTESIAN     = 1u << 9,  // I042
+    C048_VELOCITY      = 1u << 10, // I200
+    C048_TRACK_STATUS  = 1u << 11, // I170
+    C048_TRACK_QUALITY = 1u << 12, // I210
+    C048_MODE_S        = 1u << 13  // I250
+};
+
+struct Cat048Record {
+    uint32_t present = 0;         // Cat048Field flags
+    uint8_t sac = 0, sic = 0;
+    double timeOfDay = 0.0;       // Seconds since midnight UTC
+    uint8_t reportType = 0;       // I020 first octet (TYP/SIM/RDP/SPI/RAB)
+    double rho = 0.0;             // NM
+    double theta = 0.0;           // Degrees
+    uint16_t mode3A = 0;          // Octal code as a 12-bit value
+    double flightLevel = 0.0;
+    uint32_t aircraftAddress = 0;
+    char callsign[9] = {};
+    uint16_t trackNumber = 0;
+    double x = 0.0, y = 0.0;      // NM relative to the sensor
+    double groundSpeed = 0.0;     // NM/s
+    double heading = 0.0;         // Degrees
+    uint8_t trackStatus = 0;      // I170 first octet (CNF/RAD/DOU/MAH/CDM)
+    double sigmaX = 0.0, sigmaY = 0.0; // I210 standard deviation, NM
+    double sigmaV = 0.0;          // NM/s
+    double sigmaH = 0.0;          // Degrees
+    const uint8_t* modeS = nullptr;     // I250: 'modeSCount' 8-octet MB/BDS blocks, in the datagram
+    uint8_t modeSCount = 0;
+    LazyItems lazy;
+};
+
+enum Cat034Field : uint32_t {
+    C034_DATA_SOURCE   = 1u << 0,  // I010
+    C034_MESSAGE_TYPE  = 1u << 1,  // I000
+    C034_TIME          = 1u << 2,  // I030
+    C034_SECTOR        = 1u << 3,  // I020
+    C034_ROTATION      = 1u << 4,  // I041
+    C034_POSITION      = 1u << 5   // I120
+};
+
+struct Cat034Record {
+    uint32_t present = 0;         // Cat034Field flags
+    uint8_t sac = 0, sic = 0;
+    uint8_t messageType = 0;      // 1 = North marker, 2 = Sector crossing, ...
+    double timeOfDay = 0.0;
+    double sectorAzimuth = 0.0;   // Degrees
+    double rotationPeriod = 0.0;  // Seconds
+    double height = 0.0;          // Metres
+    double lat = 0.0, lon = 0.0;  // Sensor position, WGS-84 degrees
+    LazyItems lazy;
+};
+
+enum Cat021Field : uint32_t {
+    C021_DATA_SOURCE    = 1u << 0,  // I010
+    C021_DESCRIPTOR     = 1u << 1,  // I040
+    C021_TRACK_NUMBER   = 1u << 2,  // I161
+    C021_TIME           = 1u << 3,  // I071 (else I073)
+    C021_POSITION       = 1u << 4,  // I130
+    C021_POSITION_HR    = 1u << 5,  // I131
+    C021_ADDRESS        = 1u << 6,  // I080
+    C021_GEO_HEIGHT     = 1u << 7,  // I140
+    C021_QUALITY        = 1u << 8,  // I090
+    C021_MODE3A         = 1u << 9,  // I070
+    C021_FLIGHT_LEVEL   = 1u << 10, // I145
+    C021_BARO_RATE      = 1u << 11, // I155
+    C021_GEO_RATE       = 1u << 12, // I157
+    C021_VELOCITY       = 1u << 13, // I160
+    C021_IDENTIFICATION = 1u << 14, // I170
+    C021_EMITTER        = 1u << 15  // I020
+};
+
+// CAT021 edition 2.1 ADS-B target report
+struct Cat021Record {
+    uint32_t present = 0;         // Cat021Field flags
+    uint8_t sac = 0, sic = 0;
+    uint8_t descriptor = 0;       // I040 first octet (ATP/ARC/RC/RAB)
+    uint16_t trackNumber = 0;
+    double timeOfDay = 0.0;
+    double lat = 0.0, lon = 0.0;  // WGS-84 degrees (I131 when present, else I130)
+    uint32_t address = 0;         // 24-bit ICAO address
+    double geoHeight = 0.0;       // Feet
+    uint8_t nucr = 0, nic = 0;    // I090: NUCr/NACv, NUCp/NIC
+    uint8_t nacp = 0, sil = 0;    // I090 first extension (0 when absent)
+    uint16_t mode3A = 0;
+    double flightLevel = 0.0;
+    double baroRate = 0.0;        // Feet/minute
+    double geoRate = 0.0;
+    double groundSpeed = 0.0;     // NM/s
+    double trackAngle = 0.0;      // Degrees
+    char callsign[9] = {};
+    uint8_t emitter = 0;          // I020 ECAT
+    LazyItems lazy;
+};
+
+enum Cat062Field : uint32_t {
+    C062_DATA_SOURCE    = 1u << 0,  // I010
+    C062_TIME           = 1u << 1,  // I070
+    C062_POSITION       = 1u << 2,  // I105
+    C062_CARTESIAN      = 1u << 3,  // I100
+    C062_VELOCITY       = 1u << 4,  // I185
+    C062_MODE3A         = 1u << 5,  // I060
+    C062_IDENTIFICATION = 1u << 6,  // I245
+    C062_DERIVED        = 1u << 7,  // I380
+    C062_TRACK_NUMBER   = 1u << 8,  // I040
+    C062_TRACK_STATUS   = 1u << 9,  // I080
+    C062_UPDATE_AGES    = 1u << 10, // I290
+    C062_DATA_AGES      = 1u << 11, // I295
+    C062_MEASURED_FL    = 1u << 12, // I136
+    C062_GEO_ALTITUDE   = 1u << 13, // I130
+    C062_BARO_ALTITUDE  = 1u << 14, // I135
+    C062_CLIMB_RATE     = 1u << 15  // I220
+};
+
+// I380 subfields decoded into Cat062Record::derived (bit = subfield number - 1)
+enum Cat062Derived : uint32_t {
+    C062_ADR = 1u << 0,           // Target address
+    C062_ID  = 1u << 1,           // Target identification
+    C062_MHG = 1u << 2,           // Magnetic heading
+    C062_IAS = 1u << 3,           // Indicated airspeed / Mach
+    C062_TAS = 1u << 4,           // True airspeed
+    C062_SAL = 1u << 5,           // Selected altitude
+    C062_BVR = 1u << 12,          // Barometric vertical rate
+    C062_TAN = 1u << 16,          // Track angle
+    C062_GSP = 1u << 17           // Ground speed
+};
+
+// CAT062 edition 1.18 system track
+struct Cat062Record {
+    static constexpr int UPDATE_AGE_COUNT = 10;   // I290 subfields (TRK ... MLT)
+    static constexpr int DATA_AGE_COUNT = 31;     // I295 subfields (MFL ... BPS)
+
+    uint32_t present = 0;         // Cat062Field flags
+    uint8_t sac = 0, sic = 0;
+    double timeOfDay = 0.0;
+    double lat = 0.0, lon = 0.0;  // WGS-84 degrees
+    double x = 0.0, y = 0.0;      // Metres from the system reference point
+    double vx = 0.0, vy = 0.0;    // m/s, east/north
+    uint16_t mode3A = 0;
+    char callsign[9] = {};        // I245
+    uint16_t trackNumber = 0;
+    uint8_t trackStatus = 0;      // I080 first octet (MON/SPI/MRH/SRC/CNF)
+    double measuredFL = 0.0;
+    double geoAltitude = 0.0;     // Feet
+    double baroAltitude = 0.0;    // Flight level
+    double climbRate = 0.0;       // Feet/minute
+
+    // I380 aircraft derived data
+    uint32_t derived = 0;         // Cat062Derived flags
+    uint32_t address = 0;
+    char derivedId[9] = {};
+    double magHeading = 0.0;      // Degrees
+    double airspeed = 0.0;        // IAS in NM/s, or Mach when airspeedIsMach
+    bool airspeedIsMach = false;
+    double trueAirspeed = 0.0;    // Knots
+    double selectedAltitude = 0.0;// Feet
+    double baroRate = 0.0;        // Feet/minute
+    double trackAngle = 0.0;      // Degrees
+    double groundSpeed = 0.0;     // NM/s
+
+    // I290/I295 ages in 1/4 s; bit n of the mask = subfield n + 1 present
+    uint16_t updateAgeMask = 0;
+    uint16_t updateAge[UPDATE_AGE_COUNT] = {};
+    uint32_t dataAgeMask = 0;
+    uint8_t dataAge[DATA_AGE_COUNT] = {};
+    LazyItems lazy;
+};
+
+enum Cat020Field : uint32_t {
+    C020_DATA_SOURCE    = 1u << 0,  // I010
+    C020_DESCRIPTOR     = 1u << 1,  // I020
+    C020_TIME           = 1u << 2,  // I140
+    C020_POSITION       = 1u << 3,  // I041
+    C020_CARTESIAN      = 1u << 4,  // I042
+    C020_TRACK_NUMBER   = 1u << 5,  // I161
+    C020_TRACK_STATUS   = 1u << 6,  // I170
+    C020_MODE3A         = 1u << 7,  // I070
+    C020_VELOCITY       = 1u << 8,  // I202
+    C020_FLIGHT_LEVEL   = 1u << 9,  // I090
+    C020_ADDRESS        = 1u << 10, // I220
+    C020_IDENTIFICATION = 1u << 11, // I245
+    C020_GEO_HEIGHT     = 1u << 12, // I105
+    C020_ACCURACY       = 1u << 13, // I500 SDP
+    C020_CONTRIBUTORS   = 1u << 14, // I400
+    C020_MODE_S         = 1u << 15  // I250
+};
+
+// CAT020 edition 1.10 multilateration target report. The Mode S MB data
+// points into the decoded datagram, like Cat240Record::cells.
+struct Cat020Record {
+    uint32_t present = 0;         // Cat020Field flags
+    uint8_t sac = 0, sic = 0;
+    uint8_t descriptor = 0;       // I020 first octet (SSR/MS/HF/VDL4/UAT/DME/OT, RAB)
+    double timeOfDay = 0.0;
+    double lat = 0.0, lon = 0.0;  // WGS-84 degrees
+    double x = 0.0, y = 0.0;      // Metres from the system reference point
+    uint16_t trackNumber = 0;
+    uint8_t trackStatus = 0;      // I170 first octet (CNF/TRE/CST/CDM/MAH/STH)
+    uint16_t mode3A = 0;
+    double vx = 0.0, vy = 0.0;    // m/s, east/north
+    double flightLevel = 0.0;
+    uint32_t address = 0;
+    char callsign[9] = {};
+    double geoHeight = 0.0;       // Feet
+    double sigmaX = 0.0, sigmaY = 0.0;  // I500 SDP, metres
+    uint8_t contributors = 0;     // Receivers flagged in I400
+    const uint8_t* modeS = nullptr;     // I250: 'modeSCount' 8-octet MB/BDS blocks
+    uint8_t modeSCount = 0;
+    LazyItems lazy;
+};
+
+enum Cat019Field : uint32_t {
+    C019_DATA_SOURCE     = 1u << 0,  // I010
+    C019_MESSAGE_TYPE    = 1u << 1,  // I000
+    C019_TIME            = 1u << 2,  // I140
+    C019_SYSTEM_STATUS   = 1u << 3,  // I550
+    C019_PROCESSOR       = 1u << 4,  // I551
+    C019_SENSORS         = 1u << 5,  // I552
+    C019_REFERENCE_POINT = 1u << 6,  // I600
+    C019_REFERENCE_HEIGHT= 1u << 7,  // I610
+    C019_UNDULATION      = 1u << 8   // I620
+};
+
+// CAT019 edition 1.3 multilateration system status. The I552 remote sensor
+// entries (identification, status octet) point into the decoded datagram.
+struct Cat019Record {
+    uint32_t present = 0;         // Cat019Field flags
+    uint8_t sac = 0, sic = 0;
+    uint8_t messageType = 0;      // 1 start of update cycle, 2 periodic, 3 event
+    double timeOfDay = 0.0;
+    uint8_t systemStatus = 0;     // I550: NOGO (2 bits), OVL, TSV, TTF
+    uint8_t processorStatus = 0;  // I551: EXEC/GOOD for tracking processors 1-4
+    const uint8_t* sensors = nullptr;
+    uint8_t sensorCount = 0;
+    double refLat = 0.0, refLon = 0.0;  // I600, WGS-84 degrees
+    double refHeight = 0.0;       // I610, metres
+    int8_t undulation = 0;        // I620, metres
+    LazyItems lazy;
+};
+
+enum Cat240Field : uint32_t {
+    C240_DATA_SOURCE    = 1u << 0,  // I010
+    C240_MESSAGE_TYPE   = 1u << 1,  // I000
+    C240_RECORD_HEADER  = 1u << 2,  // I020
+    C240_SUMMARY        = 1u << 3,  // I030
+    C240_HEADER         = 1u << 4,  // I040 (nano) or I041 (femto)
+    C240_RESOLUTION     = 1u << 5,  // I048
+    C240_CELL_COUNT     = 1u << 6,  // I049
+    C240_CELLS          = 1u << 7,  // I050/I051/I052
+    C240_TIME           = 1u << 8   // I140
+};
+
+// CAT240 edition 1.3 radar video message. The cell octets are not copied:
+// 'cells' points into the decoded datagram and is valid as long as it is.
+struct Cat240Record {
+    uint32_t present = 0;         // Cat240Field flags
+    uint8_t sac = 0, sic = 0;
+    uint8_t messageType = 0;      // 1 = summary, 2 = video
+    uint32_t recordHeader = 0;    // Message sequence number
+    double timeOfDay = 0.0;
+    double startAz = 0.0, endAz = 0.0;  // Degrees
+    uint32_t startRange = 0;      // Index of the first cell
+    double cellDuration = 0.0;    // Seconds (two-way time per cell)
+    bool compressed = false;
+    uint8_t bitsPerCell = 0;      // 1, 2, 4, 8, 16 or 32
+    uint16_t validOctets = 0;     // I049 NB_VB
+    uint32_t cellCount = 0;       // I049 NB_CELLS
+    const uint8_t* cells = nullptr;
+    uint32_t cellBytes = 0;       // Octets of video blocks, including padding
+    LazyItems lazy;
+};
+
+// A record decoded through a loaded UapSpec: its values are a run of
+// AsterixDecodeResult::values
+struct SpecValue {
+    uint32_t field = 0;           // UapSpec field index
+    double value = 0.0;
+};
+
+struct SpecRecord {
+    uint8_t category = 0;
+    uint16_t edition = 0;
+    bool hasSource = false;
+    uint8_t sac = 0, sic = 0;
+    uint32_t firstValue = 0;
+    uint32_t valueCount = 0;
+};
+
+// CAT048 plots as columns (AsterixDecoder::setColumnar048): the decoder
+// stores the raw wire integers, then convert() scales whole columns to
+// engineering units with a SIMD kernel picked for the CPU at startup.
+// Column items outside the decoder's projection are only located, in
+// 'lazy', until AsterixDecoder::complete() parses them.
+// Rows [0, count) are valid; the vectors only grow.
+struct PlotColumns {
+    // The Cat048Field flags that have columns
+    static constexpr uint32_t FIELDS = C048_DATA_SOURCE | C048_TIME | C048_POLAR | C048_MODE3A | C048_FLIGHT_LEVEL |
+                                       C048_ADDRESS | C048_CALLSIGN | C048_MODE_S | C048_TRACK_NUMBER | C048_VELOCITY;
+
+    size_t count = 0;
+    std::vector<uint32_t> present;      // Cat048Field (DATA_SOURCE, TIME, POLAR, MODE3A, FLIGHT_LEVEL, ADDRESS,
+                                        // CALLSIGN, MODE_S, TRACK_NUMBER, VELOCITY)
+    std::vector<uint8_t> sac, sic;
+    std::vector<uint16_t> trackNumber;
+    std::vector<uint16_t> mode3A;       // I070 code
+    std::vector<uint32_t> address;      // I220
+    std::vector<std::array<char, 9>> callsign;  // I240, NUL terminated
+    std::vector<const uint8_t*> modeS;  // I250 blocks in the datagram, modeSCount of them
+    std::vector<uint8_t> modeSCount;
+    std::vector<int32_t> rawTime;       // I140, 1/128 s
+    std::vector<int32_t> rawRho;        // I040, 1/256 NM
+    std::vector<int32_t> rawTheta;      // I040, 360/2^16 degrees
+    std::vector<int32_t> rawFlightLevel;// I090, 1/4 FL (sign extended)
+    std::vector<int32_t> rawSpeed;      // I200, 2^-14 NM/s
+    std::vector<int32_t> rawHeading;    // I200, 360/2^16 degrees
+    std::vector<double> timeOfDay;      // Filled by convert()
+    std::vector<double> rho;
+    std::vector<double> theta;
+    std::vector<double> flightLevel;
+    std::vector<double> groundSpeed;    // NM/s
+    std::vector<double> heading;
+    std::vector<LazyItems> lazy;        // Located column items, per row
+
+    // New row, returns its index. Only 'present' (and 'lazy') is reset: the
+    // other columns keep whatever an earlier row left, so 'present' is the
+    // only indication of which values are valid.
+    size_t append() {
+        if (count == present.size()) grow();
+        present[count] = 0;
+        lazy[count].pending = lazy[count].located = 0;
+        return count++;
+    }
+    void clear() { count = 0; }
+    // Scale rows [from, to)
+    void convert(size_t from = 0, size_t to = SIZE_MAX);
+    // Instruction set convert() runs with, see SimdLevel.hpp
+    static const char* kernel();
+
+private:
+    void grow();
+};
+
+// Everything decoded from one UDP payload. Reused between datagrams so the
+// vectors keep their capacity and steady-state decoding does not allocate.
+struct AsterixDecodeResult {
+    std::vector<Cat034Record> cat034;
+    std::vector<Cat048Record> cat048;
+    std::vector<Cat021Record> cat021;
+    std::vector<Cat062Record> cat062;
+    std::vector<Cat240Record> cat240;
+    std::vector<Cat020Record> cat020;
+    std::vector<Cat019Record> cat019;
+    PlotColumns plots048;             // CAT048 when the decoder is columnar
+    std::vector<SpecRecord> other;    // Categories/editions from the loaded UapSpec
+    std::vector<SpecValue> values;
+    size_t blocks = 0;
+    size_t skippedBlocks = 0;     // Unsupported category or malformed
+
+    size_t records() const {
+        return cat034.size() + cat048.size() + cat021.size() + cat062.size() + cat240.size() + cat020.size() +
+               cat019.size() + plots048.count + other.size();
+    }
+    void clear() {
+        cat034.clear(); cat048.clear(); cat021.clear(); cat062.clear(); cat240.clear(); cat020.clear(); cat019.clear();
+        plots048.clear(); other.clear(); values.clear();
+        blocks = 0; skippedBlocks = 0;
+    }
+};
+
+// The typed fields one consumer reads (CatNNNField flags)
+struct AsterixProjection {
+    const char* consumer = "";
+    uint32_t cat048 = 0;
+    uint32_t cat034 = 0;
+    uint32_t cat021 = 0;
+    uint32_t cat062 = 0;
+    uint32_t cat240 = 0;
+    uint32_t cat020 = 0;
+    uint32_t cat019 = 0;
+};
+
+class UapSpec;
+
+class AsterixDecoder {
+public:
+    // Decode every data block in a datagram. Returns false if nothing could be decoded.
+    // CAT048/034/021/062/240/020/019 records go through decoders specialised on their UAP at compile time.
+    bool decode(const uint8_t* data, size_t len, AsterixDecodeResult& out) const;
+
+    // Additional categories, and per-source editions of the built-in categories, from a
+    // loaded spec. Set before decoding starts; the spec is not copied.
+    void setSpec(std::shared_ptr<const UapSpec> spec) { m_spec = std::move(spec); }
+    const UapSpec* spec() const { return m_spec.get(); }
+
+    // Consumers register what they read at startup; the decoder then parses
+    // the union and only locates the other items. With no projection
+    // registered everything is parsed.
+    void addProjection(const AsterixProjection& p);
+    uint32_t projection048() const { return m_want048; }
+    uint32_t projection034() const { return m_want034; }
+    uint32_t projection021() const { return m_want021; }
+    uint32_t projection062() const { return m_want062; }
+    uint32_t projection240() const { return m_want240; }
+    uint32_t projection020() const { return m_want020; }
+    uint32_t projection019() const { return m_want019; }
+
+    // Decode CAT048 into AsterixDecodeResult::plots048 instead of records
+    // (the built-in edition only; per-source editions still produce records)
+    void setColumnar048(bool on) { m_columns048 = on; }
+
+    // Parse located items on demand (fields already parsed are left alone)
+    static void complete(Cat048Record& r, uint32_t fields);
+    static void complete(Cat034Record& r, uint32_t fields);
+    static void complete(Cat021Record& r, uint32_t fields);
+    static void complete(Cat062Record& r, uint32_t fields);
+    static void complete(Cat240Record& r, uint32_t fields);
+    static void complete(Cat020Record& r, uint32_t fields);
+    static void complete(Cat019Record& r, uint32_t fields);
+    // Same for one row of columnar CAT048, which is then rescaled
+    static void complete(PlotColumns& c, size_t row, uint32_t fields);
+
+    // Walk one record's FSPEC against a UAP. Returns a pointer just past the
+    // record, or nullptr if the record is malformed or runs past 'end'.
+    static const uint8_t* walkRecord(const UapTable& uap, const uint8_t* p, const uint8_t* end, RecordItems& items);
+    // On-wire length of one item, or 0 if it is malformed/truncated
+    static size_t itemLength(const UapItem& it, const uint8_t* p, const uint8_t* end);
+
+    static const UapTable& uapCat034();
+    static const UapTable& uapCat048();
+    static const UapTable& uapCat021();
+    static const UapTable& uapCat062();
+    static const UapTable& uapCat240();
+    static const UapTable& uapCat020();
+    static const UapTable& uapCat019();
+
+
+private:
+    bool decodeSourceBlock(uint8_t cat, const uint8_t* rec, const uint8_t* end, AsterixDecodeResult& out) const;
+
+    std::shared_ptr<const UapSpec> m_spec;
+    bool m_projected = false;
+    uint32_t m_want048 = ~0u;
+    uint32_t m_want034 = ~0u;
+    uint32_t m_want021 = ~0u;
+    uint32_t m_want062 = ~0u;
+    uint32_t m_want240 = ~0u;
+    uint32_t m_want020 = ~0u;
+    uint32_t m_want019 = ~0u;
+    bool m_columns048 = false;
+};
+
+#endif
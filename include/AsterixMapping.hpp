@@ -0,0 +1,52 @@
+#ifndef ASTERIX_MAPPING_HPP
+#define ASTERIX_MAPPING_HPP
+
+#include "PerfectHash.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Structure to hold our mapping pair
+struct AsterixMapping {
+    std::string source; // e.g., "asterix.048_010_SAC"
+    std::string target; // e.g., "Cat48_SAC"
+    std::string group;  // Mapping-file section and key, e.g. "CAT_48_MAP" / "SAC"
+    std::string key;
+    uint8_t category = 0;   // From the source name, 0 if it has none
+    int id = -1;            // Dense field id: position in allMappings()
+};
+
+// Loads resources/tshark_config.json: tshark field -> output name, per category.
+// Compiled at load: each distinct source (after normalize()) gets a dense
+// field id in file order, and a minimal perfect hash over the normalised
+// names answers fieldId() with one hash and one slot read. Duplicate
+// sources, in any spelling, are dropped.
+class AsterixConfigParser {
+public:
+    bool loadConfig(const std::string& filename);
+
+    // nullptr when the file has no such entry
+    const AsterixMapping* getMapping(const std::string& category, const std::string& field) const;
+
+    // Position in allMappings() of a tshark source in any of its spellings
+    // ("asterix.048_040_RHO", "048_040_RHO", EK "asterix_asterix_048_040_RHO");
+    // -1 if it is not mapped
+    int fieldId(std::string_view source) const { return m_index.find(normalize(source)); }
+
+    // Every mapping, in file order (index = id)
+    const std::vector<AsterixMapping>& allMappings() const { return m_fields; }
+    const AsterixMapping& field(int id) const { return m_fields[id]; }
+    int fieldCount() const { return int(m_fields.size()); }
+
+    // "asterix.048_040_RHO" / "asterix_asterix_048_040_RHO" -> "048_040_RHO"
+    static std::string_view normalize(std::string_view source);
+
+    void printAll() const;
+
+private:
+    std::vector<AsterixMapping> m_fields;
+    PerfectHash m_index;                // Normalised source -> id
+};
+
+#endif
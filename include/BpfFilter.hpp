@@ -0,0 +1,59 @@
+#ifndef BPF_FILTER_HPP
+#define BPF_FILTER_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <linux/filter.h>
+
+// Which ASTERIX data blocks to keep; empty lists keep everything
+struct AsterixSelect {
+    std::vector<int> categories;   // CAT octet of the block
+    std::vector<int> sources;      // SAC << 8 | SIC (I010 of the block's first record)
+
+    bool empty() const { return categories.empty() && sources.empty(); }
+
+    // One data block (CAT, LEN, records), checked in user space
+    bool matches(const uint8_t* block, size_t len) const;
+
+    // Copies the selected blocks of a datagram to 'out'. Returns false, with
+    // 'out' untouched, when every block is selected (use the datagram as is).
+    // Bytes that do not parse as blocks are kept for the decoder to reject.
+    bool keepBlocks(const uint8_t* data, size_t len, std::vector<uint8_t>& out) const;
+};
+
+// Hand-assembled classic BPF programs (we do not link libpcap just to compile
+// one expression). Programs accept the whole packet or drop it.
+class BpfFilter {
+public:
+    // Equivalent of "ip and udp port <port>". 'linkHeaderLen' is 14 when the
+    // program sees Ethernet frames and 0 when it starts at the IP header
+    // (cooked AF_PACKET sockets).
+    static std::vector<sock_filter> udpPort(int port, int linkHeaderLen);
+
+    // Same, matching any of 'ports' ("ip and udp and (port a or port b ...)"),
+    // and then, if 'select' is not empty, the ASTERIX checks below
+    static std::vector<sock_filter> udpPorts(const std::vector<int>& ports, int linkHeaderLen,
+                                             const AsterixSelect& select = AsterixSelect());
+
+    // For a UDP socket (the program sees the packet from the UDP header on):
+    // keep datagrams whose first data block matches 'select'. Only the first
+    // block is inspected, so later blocks are filtered again in user space
+    // (keepBlocks). A first block of CAT002 or CAT034 passes the category
+    // check even when unselected, because radars lead with those service
+    // messages; a datagram led by any other unselected category is dropped
+    // whole.
+    static std::vector<sock_filter> asterixPayload(const AsterixSelect& select);
+
+    // SO_ATTACH_FILTER; the kernel swaps the program atomically. An empty
+    // program (one that could not be assembled) is refused.
+    static bool attach(int fd, const std::vector<sock_filter>& program);
+    static bool detach(int fd);
+
+    // Longest source list a program can hold (conditional jumps are 8-bit,
+    // so the whole program has to stay under 256 instructions). A longer
+    // list yields an empty program, which attach() refuses.
+    static constexpr size_t MAX_SOURCES = 64;
+};
+
+#endif
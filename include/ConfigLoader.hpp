@@ -4,12 +4,23 @@
 #include <string>
 #include <vector>
 #include <nlohmann/json.hpp>
+#include "BpfFilter.hpp"
+
+// One ASTERIX source (network_input.inputs[])
+struct InputConfig {
+    std::string interface;
+    int port = 8600;
+    std::string group;       // Multicast group, empty for unicast
+    std::string label;
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE(InputConfig, interface, port, group, label);
+};
 
 struct AppConfig {
     // System
     bool isMSCTactive = false;
     std::string site_name = "TARGEX_SITE";
-    int tick_rate_ms = 10;
+    int tick_rate_ms = 1000;      // Track CoT period (extrapolated); 0 = on every report
     std::string pid_file;
     int rx_port_web = 8080;
     std::string log_level = "info";
@@ -18,6 +29,30 @@ struct AppConfig {
     std::string interface;
     int rx_port = 8600;
     std::string multicast_group;
+    std::string decoder_mode = "native"; // "native" (in-process), "tshark" (EK pipe fallback)
+                                         // or "tshark-fields" (mapped columns only)
+
+    // All inputs, each with its own receive thread. inputs[0] mirrors the
+    // single interface/rx_port/multicast_group above (used by the capture ring and dumpcap).
+    std::vector<InputConfig> inputs;
+
+    // Native receive tuning
+    int recv_batch_size = 64;        // Datagrams per recvmmsg() call
+    int recv_buffer_count = 2048;    // Packet pool size (shared by capture, decoder, recorder, web feed)
+    int recv_buffer_size = 8192;     // Bytes per buffer (larger datagrams are dropped)
+    int recv_socket_buffer = 4 * 1024 * 1024; // SO_RCVBUF bytes
+
+    // Shared capture: "ring" (one TPACKET_V3 ring for recorder + decoder) or
+    // "dumpcap" (separate dumpcap recorder and socket/tshark input)
+    std::string capture_mode = "ring";
+    int ring_block_size = 1 << 20;   // Bytes, multiple of the page size
+    int ring_block_count = 64;
+    bool promiscuous = true;         // Ring puts the interface in promiscuous mode (as dumpcap did)
+
+    // Tshark fallback: number of tshark workers fed from our own capture
+    // (at least one); "roundrobin" or "sacsic" (same sensor -> same worker)
+    int tshark_workers = 1;
+    std::string tshark_dispatch = "roundrobin";
 
     bool isEnabled = true;
     std::string destination; // File output path
@@ -35,7 +70,7 @@ struct AppConfig {
     // Toggles
     bool send_sensor_pos = false; // Send the Origin Point (Green Dot)
     bool send_tak_tracks = false; // [NEW] Send the actual Cat 48 Tracks
-    bool send_asterix = false; // send ASterix
+    bool send_asterix = false; // Relay received ASTERIX datagrams, unchanged, to asterix_ip:asterix_port
 
     // SSL Configuration [NEW]
     std::string ssl_client_cert;
@@ -43,9 +78,18 @@ struct AppConfig {
     std::string ssl_trust_store;
     std::string ssl_trust_pass;
 
-    // Processing
+    // Processing: applied in the kernel (socket BPF) to the first data block
+    // of each datagram, then to every block on the decode thread. Empty lists
+    // accept everything. A datagram whose first block is an unselected
+    // category other than CAT002/CAT034 is dropped whole in the kernel.
     std::vector<int> active_categories;
+    std::vector<int> allowed_sources;   // SAC << 8 | SIC
     
+    // Radar video (CAT240): PPI raster served as map tiles on /api/video
+    bool video_enabled = false;
+    double video_range_nm = 32.0;    // Radius covered by the raster
+    int video_raster_size = 1024;    // Pixels across
+
     std::string active_log_path; 
 
     // Track the active recording
@@ -55,12 +99,27 @@ struct AppConfig {
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(AppConfig, 
         rx_port, cot_ip, cot_port, cot_protocol, 
         send_sensor_pos, send_tak_tracks, 
-        send_asterix, asterix_ip, asterix_port,
+        send_asterix, asterix_ip, asterix_port, decoder_mode, inputs,
+        active_categories,
         ssl_client_cert, ssl_client_pass, ssl_trust_store, ssl_trust_pass
     );
 };
 class ConfigLoader {
 public:
     static bool load(const std::string& path, AppConfig& config);
+
+    // Fill config.inputs from network_input.inputs[] (or the single legacy
+    // interface/port/multicast_group when there is no array)
+    static void parseInputs(const nlohmann::json& networkInput, AppConfig& config);
+
+    // "processing": active_categories and allowed_sources ([{"sac":..,"sic":..}]).
+    // A list longer than BpfFilter::MAX_SOURCES is rejected: false, and
+    // 'select' / the config are left as they were.
+    static bool parseSelect(const nlohmann::json& processing, AsterixSelect& select);
+    static bool parseProcessing(const nlohmann::json& processing, AppConfig& config);
+    static nlohmann::json sourcesToJson(const std::vector<int>& sources);
+
+    // "video": enabled, range_nm, raster_size
+    static void parseVideo(const nlohmann::json& video, AppConfig& config);
 };
 #endif
\ No newline at end of file
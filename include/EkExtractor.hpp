@@ -0,0 +1,68 @@
+#ifndef EK_EXTRACTOR_HPP
+#define EK_EXTRACTOR_HPP
+
+#include "PerfectHash.hpp"
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class AsterixConfigParser;
+
+// Fixed ids for the fields the live pipeline always needs
+enum EkFieldId : uint8_t {
+    EK_LAT = 0,
+    EK_LON,
+    EK_RHO,
+    EK_THETA,
+    EK_TRACK_NUMBER,
+    EK_CATEGORY,
+    EK_SAC,
+    EK_SIC,
+    EK_CORE_COUNT
+};
+
+// Values pulled from one EK line; plain data, reused between lines
+struct EkFields {
+    uint32_t present = 0;          // Bit per EkFieldId
+    bool hasAsterix = false;       // The line carried an "asterix" layer
+    double values[EK_CORE_COUNT];
+
+    bool has(int id) const { return (present >> id) & 1; }
+    double get(int id) const { return values[id]; }
+    void clear() { present = 0; hasAsterix = false; }
+};
+
+// Single-pass scanner for tshark "-T ek" lines. Walks the text once and
+// parses only the values of the core fields (std::from_chars); no DOM and no
+// allocation per line. Keys are matched after their "asterix_" layer prefixes,
+// e.g. "asterix_asterix_048_040_RHO" matches "048_040_RHO". A value that tshark
+// emitted as an array (several records in one block) yields its first element.
+//
+// compile() resolves every key to a dense field id once: mapped sources keep
+// their AsterixConfigParser id, core keys the mapping lacks get ids after
+// those. A minimal perfect hash over the normalised keys gives the id of a
+// line's key with one hash and no string compare; the id then indexes the
+// core slot table.
+class EkExtractor {
+public:
+    EkExtractor() { compile(nullptr); }
+
+    // Rebuild the key index against a loaded mapping (nullptr: core keys
+    // only). Returns false if no index could be built; extract() then
+    // matches nothing.
+    bool compile(const AsterixConfigParser* mapping);
+
+    // Returns false if the line is not a JSON object
+    bool extract(const char* line, size_t len, EkFields& out) const;
+
+    // Numeric value at p as tshark prints it: 1.5, "1.5", 0x1F, or the first
+    // element of an array of those
+    static bool parseNumber(const char* p, const char* end, double& out);
+
+private:
+    PerfectHash m_index;            // Normalised key -> field id
+    std::vector<int8_t> m_slot;     // Field id -> EkFieldId, -1 when not read
+};
+
+#endif
@@ -2,35 +2,148 @@
 #define MARS_ENGINE_HPP
 
 #include "ConfigLoader.hpp"
+#include "AsterixDecoder.hpp"
+#include "AdsbTable.hpp"
+#include "TrackStore.hpp"
+#include "TrackFusion.hpp"
+#include "TimingWheel.hpp"
+#include "MlatStatus.hpp"
+#include "EkExtractor.hpp"
+#include "TsharkFields.hpp"
+#include "PacketPool.hpp"
+#include "VideoRaster.hpp"
+#include "WebFeed.hpp"
+#include <memory>
 #include <string>
 #include <vector>
 #include <deque>
 #include <mutex>
 #include <atomic>
 #include <thread>
+#include <condition_variable>
 #include <nlohmann/json.hpp>
 
+class PacketRing;
+class UdpReceiver;
+
 // OpenSSL Forward Declarations (Avoids pulling heavy headers here)
 typedef struct ssl_st SSL;
 typedef struct ssl_ctx_st SSL_CTX;
 
+// Position/identity of one target report, independent of the decoder that produced it
+struct PlotReport {
+    uint8_t category = 0;
+    bool hasSource = false;
+    uint8_t sac = 0, sic = 0;
+    double timeOfDay = -1;        // Seconds since midnight UTC, negative if unknown
+    uint64_t trackKey = 0;        // TrackStore::key(), 0 for plots that belong to no track
+    std::string id;               // Track number (or ICAO address), empty if none
+    std::string callsign;         // Shown instead of the id when known
+    double lat = 0, lon = 0;
+    double rho = -1, theta = 0;
+    bool isGeo = false;
+    bool isPolar = false;
+    bool isProjected = false;     // Polar plot whose lat/lon the batch path already computed
+    bool hasVelocity = false;
+    double course = 0;            // Degrees true
+    double speed = 0;             // m/s
+    bool hasFlightLevel = false;
+    double flightLevel = 0;
+    bool hasAddress = false;      // Identity for multi-sensor fusion
+    uint32_t address = 0;
+    bool hasMode3A = false;
+    uint16_t mode3A = 0;
+    const ModeSData* modeS = nullptr;   // Comm-B registers; valid during handleReport()
+};
+
 class MarsEngine {
 public:
-    MarsEngine(AppConfig& config);
+    MarsEngine(AppConfig& config, PacketPool& pool);
     ~MarsEngine();
 
     void start();
     void stop();
+
+    // Decode from the shared capture ring instead of a UDP socket (call before start)
+    void attachRing(PacketRing* ring) { m_ring = ring; }
     
-    // API for WebServer to get visualization data
-    std::vector<nlohmann::json> pollData();
+    // API for WebServer to get visualization data: replaces 'out' with a JSON
+    // array of the WebRecords reported since the last poll
+    void pollData(std::string& out) { m_web.drain(out); }
+    // Current track picture, sensor then fused tracks, as a JSON array or CSV
+    void exportTracks(std::string& out, bool csv) const;
+    PacketPool::Stats poolStats() const { return m_pool.stats(); }
+
+    // Per-input receive counters, in AppConfig::inputs order
+    struct InputStats {
+        std::string label;
+        uint64_t datagrams = 0;
+        uint64_t truncated = 0;
+    };
+    std::vector<InputStats> inputStats() const;
+    // Attach 'select' to every capture socket. It becomes active_categories /
+    // allowed_sources only if every socket took it; otherwise the previous
+    // filter is put back and false is returned.
+    bool applyFilter(const AsterixSelect& select);
+
+    // Radar video PPI (video_enabled): tile z/x/y as PNG, false when there is nothing to show
+    bool videoTile(int z, int x, int y, std::string& png) const { return m_video && m_video->tilePng(z, x, y, png); }
+    VideoRaster::Stats videoStats() const { return m_video ? m_video->stats() : VideoRaster::Stats(); }
+    bool videoHasOrigin() const { return m_video && m_video->hasOrigin(); }
+
+    // Per-system MLAT health from CAT019 (JSON array for /api/status)
+    nlohmann::json mlatStatus() const;
+
     // Status Getter
     bool isTcpConnected() const { return m_tcpConnected; }
 
 private:
     void processLoop();
+    // Decoder back-ends (selected by AppConfig::decoder_mode)
+    void runTsharkPoolLoop();
+    std::string prepareTsharkOutput();
+    void runDecodeLoop();
+
+    // Ingest: the capture ring or one receive thread per input, into m_ingestQueue
+    void startIngest();
+    void stopIngest();
+    void receiveLoop(size_t index);
+    void enqueueIngest(std::vector<PacketRef>& batch);
+    void notifyIngest();
+    void handleDatagram(const PacketRef& pkt);
+    // The blocks of pkt the filter selects (the kernel checked only the
+    // first); false when none is left
+    bool selectBlocks(const PacketRef& pkt, const uint8_t*& data, uint32_t& len);
+
+    // Shared by both back-ends: sensor origin tracking and CoT output
+    void handleReport(const PlotReport& report, double now);
+    size_t updateTrack(const PlotReport& r, double now, bool* moved);
+    std::string trackCot(const TrackStore& t, size_t row, double lat, double lon) const;
+    void serviceTimers();
+    int nextTimerMs() const;
+    void startTimers();
+    void expireTrack(TrackStore& store, uint16_t kind, uint64_t key, uint64_t nowMs);
+    void setOrigin(uint8_t sac, uint8_t sic, double lat, double lon);
+    void sendSensorCot();
+    void sendHeartbeat();
+    uint64_t trackTickMs() const;
+    void sendTrackTick(uint64_t nowMs);
+    void handleEkLine(const char* line, size_t len);
+    void handleFieldsLine(const char* line, size_t len);
+    void reportDecoded(const AsterixDecodeResult& decoded);
+    void reportPlots(const AsterixDecodeResult& decoded);
+    const ModeSData* modeS(uint32_t address, const uint8_t* blocks, uint8_t count, double now);
+    const ModeSData* currentModeS(uint32_t address, double now) const;
+    void pushWeb(const PlotReport& r, long trackRow = -1);
+    void pushWeb(const SpecRecord& rec, const AsterixDecodeResult& decoded);
+    void pushVideo(const PacketRef& pkt);
+    void videoLoop();
+    void relayAsterix(const void* data, size_t len);
     // Helper to route packets based on Protocol (UDP/TCP)
     void sendToTak(const std::string& xml);
+    void writeTak(const char* data, size_t len);
+    void beginCotBatch();
+    void flushCotBatch();
     
     //  Manages TCP Reconnection logic
     void manageTcpConnection();
@@ -40,22 +153,105 @@ private:
     void cleanupSSL();
 
     AppConfig& m_config;
+    PacketPool& m_pool;
     std::atomic<bool> m_isRunning{false};
     std::thread m_workerThread;
 
-    // Thread-safe buffer for the Web Interface
-    std::deque<nlohmann::json> m_webQueue;
-    std::mutex m_queueMutex;
+    // Reports waiting for the Web Interface (fixed-size records, rendered in pollData)
+    WebFeed m_web;
     
-    // State for CoT Generation
-    double m_sensorLat = 0.0;
-    double m_sensorLon = 0.0;
-    bool m_hasOrigin = false;
+    // Tracks by (kind, SAC, SIC, number): updated by the decode thread, read
+    // by every output (CoT, web feed, /api/tracks). Sensor tracks are fused
+    // across sources into m_fused, which is what TAK and the map see.
+    TrackStore m_tracks;
+    TrackStore m_fused;
+    TrackFusion m_fusion;
+    mutable std::mutex m_trackMutex;
+
+    // Everything time-driven on the decode thread: track expiry, fusion, sensor CoT,
+    // heartbeats, reconnect backoff, table housekeeping (steady clock, ms)
+    enum TimerKind : uint16_t {
+        TIMER_TRACK_EXPIRY,     // payload: m_tracks key
+        TIMER_FUSED_EXPIRY,     // payload: m_fused key
+        TIMER_FUSION_GRID,      // Re-index fused tracks for association
+        TIMER_SENSOR_COT,
+        TIMER_HEARTBEAT,
+        TIMER_RECONNECT,
+        TIMER_HOUSEKEEPING,
+        TIMER_TRACK_TICK        // Extrapolated track CoT, every tick_rate_ms
+    };
+    TimingWheel m_timers;
+    std::vector<TimingWheel::Fired> m_firedTimers;
+    TimingWheel::TimerId m_reconnectTimer = 0;
+    uint64_t m_reconnectBackoffMs = 0;
+
+    // Radar sites by source (sac << 8 | sic) from CAT034 I120: each radar's
+    // polar plots are placed from its own site (decode thread only)
+    struct SensorOrigin {
+        uint16_t source;
+        double lat, lon;
+    };
+    std::vector<SensorOrigin> m_origins;
+    const SensorOrigin* origin(uint8_t sac, uint8_t sic) const;
+
+    // Native decoding state (reused between datagrams). Each decoder parses
+    // the fields its consumers registered.
+    AsterixDecoder m_decoder;
+    AsterixDecodeResult m_decoded;
+    std::vector<double> m_plotLat, m_plotLon;   // Projected CAT048 columns
+    std::vector<uint8_t> m_plotProjected;       // Per row: its radar's site was known
+
+    // Radar video: CAT240 datagrams are handed to their own thread so raster
+    // updates never hold up plot decoding
+    std::unique_ptr<VideoRaster> m_video;
+    AsterixDecoder m_videoDecoder;
+    std::thread m_videoThread;
+    std::deque<PacketRef> m_videoQueue;
+    std::mutex m_videoMutex;
+    std::condition_variable m_videoCv;
+
+    // ADS-B aircraft by 24-bit address: changed by the decode thread under
+    // m_adsbMutex, which other threads hold to read it (exportTracks)
+    AdsbTable m_adsb;
+    mutable std::mutex m_adsbMutex;
+    MlatStatusTable m_mlat;
+
+    // Tshark fallback: keys indexed once, values pulled per line
+    EkExtractor m_ekExtractor;
+    EkFields m_ekFields;
+    TsharkFields m_tsharkFields;   // Column layout, fixed once tshark starts
+
+    // Ingest queue: filled by the capture ring or the per-input receive
+    // threads, drained by the single decode thread (processLoop)
+    PacketRing* m_ring = nullptr;
+    std::vector<std::thread> m_rxThreads;
+    struct InputCounters {
+        std::atomic<uint64_t> datagrams{0};
+        std::atomic<uint64_t> truncated{0};
+    };
+    std::deque<InputCounters> m_inputCounters;
+    int m_ringSinkId = -1;
+    std::mutex m_rxMutex;              // Guards m_receivers and the config filter lists
+    std::vector<UdpReceiver*> m_receivers;
+    // Decode thread's copy of the filter lists, refreshed when applyFilter()
+    // bumps m_selectVersion
+    std::atomic<uint32_t> m_selectVersion{0};
+    uint32_t m_blockSelectVersion = ~0u;
+    AsterixSelect m_blockSelect;
+    std::vector<uint8_t> m_blockScratch;
+    std::atomic<int> m_ingestEventFd{-1};   // Also signalled when the consumer polls descriptors
+    std::deque<PacketRef> m_ingestQueue;
+    std::mutex m_ingestMutex;
+    std::condition_variable m_ingestCv;
     // --- NETWORKING STATE ---
     int m_udpSock = -1;
     int m_tcpSock = -1;
+    int m_astSock = -1;
     bool m_tcpConnected = false;
-    std::chrono::steady_clock::time_point m_lastTcpAttempt;
+    // CoT events queued while one datagram is reported
+    bool m_cotBatching = false;
+    std::string m_cotBatch;
+    std::vector<size_t> m_cotBatchEnds;
 
     // SSL State
     SSL_CTX* m_sslCtx = nullptr;
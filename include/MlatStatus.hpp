@@ -0,0 +1,46 @@
+#ifndef MLAT_STATUS_HPP
+#define MLAT_STATUS_HPP
+
+#include "AsterixDecoder.hpp"
+#include <cstdint>
+#include <mutex>
+#include <nlohmann/json.hpp>
+
+// Health of each multilateration system, from its CAT019 status messages.
+// Fixed capacity: update() runs per status message on the decode thread
+// and never allocates; toJson() renders a snapshot for /api/status.
+class MlatStatusTable {
+public:
+    static constexpr size_t MAX_SYSTEMS = 16;
+    static constexpr size_t MAX_SENSORS = 64;   // Remote sensors kept per system
+
+    struct Sensor {
+        uint8_t id = 0;
+        uint8_t status = 0;       // I552 status octet (RS1090, TX1030, TX1090, RSS, RSO)
+    };
+
+    struct System {
+        uint8_t sac = 0, sic = 0;
+        uint8_t systemStatus = 0;
+        uint8_t processorStatus = 0;
+        bool hasSystemStatus = false;
+        bool hasProcessorStatus = false;
+        uint8_t sensorCount = 0;
+        Sensor sensors[MAX_SENSORS];
+        bool hasReference = false;
+        double refLat = 0.0, refLon = 0.0, refHeight = 0.0;
+        double lastSeen = 0.0;    // Caller's clock, seconds
+        uint64_t messages = 0;
+    };
+
+    // Returns false when the table is full and the system is new
+    bool update(const Cat019Record& r, double now);
+    nlohmann::json toJson(double now) const;
+
+private:
+    mutable std::mutex m_mutex;
+    System m_systems[MAX_SYSTEMS];
+    size_t m_count = 0;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef MODE_S_HPP
+#define MODE_S_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+enum ModeSField : uint16_t {
+    MS_SELECTED_ALTITUDE = 1u << 0,   // BDS 4,0 MCP/FCU
+    MS_FMS_ALTITUDE      = 1u << 1,   // BDS 4,0
+    MS_BARO_SETTING      = 1u << 2,   // BDS 4,0
+    MS_ROLL              = 1u << 3,   // BDS 5,0
+    MS_TRUE_TRACK        = 1u << 4,   // BDS 5,0
+    MS_GROUND_SPEED      = 1u << 5,   // BDS 5,0
+    MS_TRACK_RATE        = 1u << 6,   // BDS 5,0
+    MS_TRUE_AIRSPEED     = 1u << 7,   // BDS 5,0
+    MS_MAG_HEADING       = 1u << 8,   // BDS 6,0
+    MS_IAS               = 1u << 9,   // BDS 6,0
+    MS_MACH              = 1u << 10,  // BDS 6,0
+    MS_BARO_RATE         = 1u << 11,  // BDS 6,0
+    MS_INERTIAL_RATE     = 1u << 12   // BDS 6,0
+};
+
+// Comm-B registers decoded for one aircraft. Kept per 24-bit address
+// (AdsbTable::Entry), so a register whose MB field repeats unchanged in
+// later scans is recognised by its last raw value and not decoded again.
+struct ModeSData {
+    uint16_t present = 0;         // ModeSField flags
+    double selectedAltitude = 0;  // Feet
+    double fmsAltitude = 0;       // Feet
+    double baroSetting = 0;       // hPa
+    double roll = 0;              // Degrees, right wing down positive
+    double trueTrack = 0;         // Degrees
+    double groundSpeed = 0;       // Knots
+    double trackRate = 0;         // Degrees/second
+    double trueAirspeed = 0;      // Knots
+    double magHeading = 0;        // Degrees
+    double ias = 0;               // Knots
+    double mach = 0;
+    double baroRate = 0;          // Feet/minute
+    double inertialRate = 0;      // Feet/minute
+
+    // Last MB field accepted per register (BDS 4,0 / 5,0 / 6,0), 0 = none yet
+    uint64_t lastMb[3] = {};
+};
+
+// One derived value as the exports name and format it
+struct ModeSValue {
+    uint16_t flag;                // ModeSField
+    double ModeSData::*value;
+    const char* name;             // CSV column / JSON key, e.g. "selected_altitude_ft"
+    const char* format;           // printf format
+};
+constexpr size_t MODE_S_VALUE_COUNT = 13;
+extern const ModeSValue MODE_S_VALUES[MODE_S_VALUE_COUNT];   // In ModeSField order
+
+// Apply the I250 blocks of one report (8 octets each: 56-bit MB, then
+// BDS1/BDS2) to 'state'. Registers other than 4,0 / 5,0 / 6,0, and MB
+// fields that fail the register's consistency checks, are ignored.
+// Returns how many 4,0 / 5,0 / 6,0 registers the report carried that are
+// now current: decoded, or unchanged since they last were.
+int decodeModeS(const uint8_t* blocks, size_t count, ModeSData& state);
+
+// Native pass over a pcap recording: one CSV row per CAT048/CAT020 report
+// with Mode S MB data, carrying the aircraft's decoded registers.
+bool exportModeSCsv(const std::string& pcapPath, const std::string& csvPath);
+
+#endif
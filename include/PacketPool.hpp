@@ -0,0 +1,94 @@
+#ifndef PACKET_POOL_HPP
+#define PACKET_POOL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class PacketPool;
+
+// One slab slot. Filled once by the capture stage, then shared read-only.
+struct PacketBuffer {
+    std::atomic<uint32_t> refs{0};
+    PacketPool* pool = nullptr;
+    uint8_t* data = nullptr;       // Slab storage, 'capacity' bytes
+    uint32_t capacity = 0;
+
+    // Filled by the producer
+    uint32_t len = 0;              // Bytes used in 'data'
+    uint32_t origLen = 0;          // Length on the wire (frames may be truncated)
+    uint32_t payloadOff = 0;       // UDP payload inside 'data' (past the headers of a captured frame)
+    uint32_t payloadLen = 0;
+    uint32_t tsSec = 0, tsNsec = 0;
+    bool outgoing = false;
+    uint16_t input = 0;            // Index into AppConfig::inputs
+};
+
+// Shared handle to a PacketBuffer. Copying takes a reference; the buffer goes
+// back to its pool's free list when the last handle is released.
+class PacketRef {
+public:
+    PacketRef() = default;
+    explicit PacketRef(PacketBuffer* buf) : m_buf(buf) {}   // Adopts the initial reference
+    PacketRef(const PacketRef& o) : m_buf(o.m_buf) { if (m_buf) m_buf->refs.fetch_add(1, std::memory_order_relaxed); }
+    PacketRef(PacketRef&& o) noexcept : m_buf(o.m_buf) { o.m_buf = nullptr; }
+    PacketRef& operator=(PacketRef o) noexcept { std::swap(m_buf, o.m_buf); return *this; }
+    ~PacketRef() { reset(); }
+
+    void reset();
+
+    explicit operator bool() const { return m_buf != nullptr; }
+    PacketBuffer* operator->() const { return m_buf; }
+    PacketBuffer& operator*() const { return *m_buf; }
+
+    const uint8_t* payload() const { return m_buf->data + m_buf->payloadOff; }
+    uint32_t payloadLen() const { return m_buf->payloadLen; }
+
+private:
+    PacketBuffer* m_buf = nullptr;
+};
+
+class PacketPool {
+public:
+    struct Stats {
+        size_t capacity = 0;
+        size_t inUse = 0;
+        size_t highWater = 0;
+        uint64_t exhausted = 0;    // acquire() calls that found no free buffer
+        uint32_t bufferSize = 0;
+    };
+
+    PacketPool(size_t count, uint32_t bufferSize);
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+    // Returns an empty ref when the pool is exhausted (the caller drops the packet)
+    PacketRef acquire();
+    Stats stats() const;
+    uint32_t bufferSize() const { return m_bufferSize; }
+
+private:
+    friend class PacketRef;
+    void release(PacketBuffer* buf);
+
+    uint32_t m_bufferSize;
+    std::vector<uint8_t> m_slab;
+    std::vector<PacketBuffer> m_buffers;
+
+    mutable std::mutex m_mutex;
+    std::vector<PacketBuffer*> m_free;
+    size_t m_highWater = 0;
+    uint64_t m_exhausted = 0;
+};
+
+inline void PacketRef::reset() {
+    if (m_buf && m_buf->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        m_buf->pool->release(m_buf);
+    }
+    m_buf = nullptr;
+}
+
+#endif
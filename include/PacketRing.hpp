@@ -0,0 +1,84 @@
+#ifndef PACKET_RING_HPP
+#define PACKET_RING_HPP
+
+#include "ConfigLoader.hpp"
+#include "PacketPool.hpp"
+#include "BpfFilter.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+
+// AF_PACKET TPACKET_V3 block ring on AppConfig::interface, filtered in the
+// kernel to "udp port rx_port" (plus the active_categories / allowed_sources
+// selection, which also applies to recordings). Each frame is copied once from the mapped
+// block into a pooled buffer, and every consumer (recorder, decoder) gets a
+// handle to that same buffer. The interface is put in promiscuous mode
+// (network_input.promiscuous) and the inputs' multicast groups are joined.
+class PacketRing {
+public:
+    using Sink = std::function<void(const PacketRef&)>;
+
+    PacketRing(AppConfig& config, PacketPool& pool);
+    ~PacketRing();
+
+    bool open();
+    void start();
+    void stop();
+    bool isOpen() const { return m_fd != -1; }
+
+    // Sinks run on the capture thread, in registration order. They should
+    // only queue the handle; the work happens on the consumer's own thread.
+    int addSink(Sink sink);
+    void removeSink(int id);
+
+    uint32_t linkType() const { return m_linkType; }   // PcapWriter::LINKTYPE_*
+    int linkHeaderLen() const { return m_linkHeaderLen; }
+    int fd() const { return m_fd; }
+
+    // Rebuild the kernel filter with a new ASTERIX selection (atomic swap)
+    bool setFilter(const AsterixSelect& select);
+
+    // Locate the UDP payload inside a captured frame
+    static bool udpPayload(const uint8_t* frame, uint32_t capLen, int linkHeaderLen,
+                           const uint8_t*& payload, uint32_t& payloadLen);
+
+    // Cumulative counters (drops come from PACKET_STATISTICS)
+    uint64_t packets() const { return m_packets; }
+    uint64_t drops() const { return m_drops; }
+    uint64_t poolDrops() const { return m_poolDrops; }
+
+private:
+    void captureLoop();
+    void dispatchBlock(uint8_t* block);
+    void readStats();
+    void joinInterface(int ifindex);
+
+    AppConfig& m_config;
+    PacketPool& m_pool;
+    int m_fd = -1;
+    int m_joinFd = -1;                 // UDP socket holding the multicast memberships
+    uint8_t* m_map = nullptr;
+    size_t m_mapLen = 0;
+    uint32_t m_blockSize = 0;
+    uint32_t m_blockCount = 0;
+    uint32_t m_linkType = 0;
+    int m_linkHeaderLen = 0;
+    std::vector<int> m_ports;
+
+    std::atomic<bool> m_isRunning{false};
+    std::thread m_thread;
+
+    std::mutex m_sinkMutex;
+    std::vector<std::pair<int, Sink>> m_sinks;
+    int m_nextSinkId = 1;
+
+    std::atomic<uint64_t> m_packets{0};
+    std::atomic<uint64_t> m_drops{0};
+    std::atomic<uint64_t> m_poolDrops{0};
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef PCAP_WRITER_HPP
+#define PCAP_WRITER_HPP
+
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+
+// Minimal libpcap-format file writer (nanosecond timestamps).
+class PcapWriter {
+public:
+    static constexpr uint32_t LINKTYPE_ETHERNET = 1;
+    static constexpr uint32_t LINKTYPE_RAW = 101;   // Packet starts at the IP header
+
+    PcapWriter() = default;
+    ~PcapWriter();
+    PcapWriter(const PcapWriter&) = delete;
+    PcapWriter& operator=(const PcapWriter&) = delete;
+
+    bool open(const std::string& path, uint32_t linkType, uint32_t snapLen = 262144);
+    void close();
+    bool isOpen() const { return m_file != nullptr; }
+
+    void write(uint32_t tsSec, uint32_t tsNsec, const uint8_t* data, uint32_t capLen, uint32_t origLen);
+    void flush();
+
+    // Same format into a memory buffer, for streaming pcap down a pipe
+    static void appendFileHeader(std::string& out, uint32_t linkType, uint32_t snapLen = 262144);
+    static void appendRecord(std::string& out, uint32_t tsSec, uint32_t tsNsec,
+                             const uint8_t* data, uint32_t capLen, uint32_t origLen);
+
+private:
+    FILE* m_file = nullptr;
+};
+
+#endif
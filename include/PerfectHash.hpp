@@ -0,0 +1,51 @@
+#ifndef PERFECT_HASH_HPP
+#define PERFECT_HASH_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Minimal perfect hash over a fixed key set (hash and displace). Built once
+// at load time; a lookup hashes the key once, reads one displacement and
+// one slot, and confirms the hit by its stored 64-bit hash, so no string
+// is ever compared.
+class PerfectHash {
+public:
+    // Keys must be distinct. Returns false if no layout was found (does
+    // not happen in practice; the seed is retried many times).
+    bool build(const std::vector<std::string_view>& keys);
+
+    // Index of the key in the build() list, -1 if it was not there
+    int find(std::string_view key) const {
+        if (m_slots.empty()) return -1;
+        uint64_t h = hash(key, m_seed);
+        uint64_t slot = mix(h ^ m_disp[(h >> 32) % m_disp.size()]) % m_slots.size();
+        return m_slots[slot].hash == h ? m_slots[slot].index : -1;
+    }
+
+    size_t size() const { return m_slots.size(); }
+
+    static uint64_t hash(std::string_view key, uint64_t seed) {
+        uint64_t h = 14695981039346656037ull ^ seed;   // FNV-1a, 64-bit
+        for (char c : key) { h ^= uint8_t(c); h *= 1099511628211ull; }
+        return mix(h);
+    }
+
+private:
+    // splitmix64 finaliser
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27; x *= 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    struct Slot {
+        uint64_t hash = 0;
+        int32_t index = -1;
+    };
+    uint64_t m_seed = 0;
+    std::vector<uint64_t> m_disp;       // Per bucket
+    std::vector<Slot> m_slots;          // Exactly one per key
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef PIPE_READER_HPP
+#define PIPE_READER_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+
+// Non-blocking line reader over a child process's stdout (tshark -l).
+// Lines are framed in a growable buffer and handed out in place, so a line
+// of any length arrives whole and is never copied before parsing.
+class PipeReader {
+public:
+    // Called once per complete line, without the trailing newline. The
+    // pointer is only valid for the duration of the call.
+    using LineHandler = std::function<void(const char* line, size_t len)>;
+
+    PipeReader() = default;
+    ~PipeReader();
+    PipeReader(const PipeReader&) = delete;
+    PipeReader& operator=(const PipeReader&) = delete;
+
+    bool open(const std::string& cmd);
+    // Read from a descriptor the caller created (e.g. a child's stdout); closed by close()
+    bool attach(int fd);
+    void close();
+    bool isOpen() const { return m_fd != -1; }
+    int fd() const { return m_fd; }
+
+    // Wait up to timeoutMs for output, then frame what is available, at
+    // most MAX_READS reads' worth so the caller gets control back. Returns
+    // the number of lines delivered (0 on timeout), -1 once the child has
+    // closed its end.
+    int read(int timeoutMs, const LineHandler& onLine);
+
+    // Counters
+    uint64_t lines() const { return m_lines; }
+    uint64_t oversized() const { return m_oversized; }
+
+    // A line longer than this is discarded rather than buffered forever
+    static constexpr size_t MAX_LINE = 16 * 1024 * 1024;
+    static constexpr int MAX_READS = 16;
+
+private:
+    int frame(const LineHandler& onLine);
+
+    FILE* m_pipe = nullptr;
+    int m_fd = -1;
+
+    std::vector<char> m_buf;
+    size_t m_used = 0;       // Bytes held in m_buf
+    size_t m_scanned = 0;    // Prefix of m_buf already searched for '\n'
+    bool m_discarding = false;
+
+    uint64_t m_lines = 0;
+    uint64_t m_oversized = 0;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef SIMD_LEVEL_HPP
+#define SIMD_LEVEL_HPP
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#endif
+
+// CPU dispatch for the column kernels that come in avx2, sse2 and scalar
+// versions (PlotColumns::convert, TrackStore::predict). The vector
+// versions are compiled with target attributes, so the binary still runs
+// on CPUs without them.
+enum class SimdLevel { Scalar, Sse2, Avx2 };
+
+// Widest level this CPU runs, resolved once on first use
+inline SimdLevel simdLevel() {
+    static const SimdLevel level = [] {
+#ifdef SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+        if (__builtin_cpu_supports("sse2")) return SimdLevel::Sse2;
+#endif
+        return SimdLevel::Scalar;
+    }();
+    return level;
+}
+
+// "avx2", "sse2" or "scalar"
+inline const char* simdName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Sse2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+#ifdef SIMD_X86
+// The version of a kernel for this CPU
+template <typename Kernel>
+inline Kernel simdKernel(Kernel scalar, Kernel sse2, Kernel avx2) {
+    switch (simdLevel()) {
+        case SimdLevel::Avx2: return avx2;
+        case SimdLevel::Sse2: return sse2;
+        default: return scalar;
+    }
+}
+#else
+template <typename Kernel>
+inline Kernel simdKernel(Kernel scalar) { return scalar; }
+#endif
+
+#endif
@@ -2,6 +2,9 @@
 #define TARGEX_CORE_HPP
 
 #include "ConfigLoader.hpp"
+#include "PcapWriter.hpp"
+#include "PacketPool.hpp"
+#include <condition_variable>
 #include <string>
 #include <vector>
 #include <mutex>
@@ -10,6 +13,8 @@
 #include <deque> // For the queue
 #include <nlohmann/json.hpp>
 
+class PacketRing;
+
 class TargexCore {
 public:
     TargexCore(AppConfig& config);
@@ -19,6 +24,9 @@ public:
     void startCapture();
     void stopCapture();
 
+    // Record from the shared capture ring instead of spawning dumpcap
+    void attachRing(PacketRing* ring) { m_ring = ring; }
+
     // Now simply pops from the queue
     nlohmann::json pollData();
 
@@ -29,6 +37,14 @@ private:
     std::atomic<bool> m_isCapturing{false};
     std::string m_currentFile;
 
+    // Shared ring recording: the ring thread only queues handles,
+    // captureLoop() writes them out
+    PacketRing* m_ring = nullptr;
+    int m_sinkId = -1;
+    PcapWriter m_writer;
+    std::deque<PacketRef> m_recordQueue;
+    std::condition_variable m_recordCv;
+
     // --- NEW: Threaded Buffer ---
     std::thread m_captureThread;
     std::deque<nlohmann::json> m_packetQueue;
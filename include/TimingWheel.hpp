@@ -0,0 +1,70 @@
+#ifndef TIMING_WHEEL_HPP
+#define TIMING_WHEEL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Hierarchical timing wheel with 1 ms ticks: four levels of 256 slots
+// (256 ms, 65 s, 4.6 h, 49 days per turn). Timers are intrusive list nodes
+// in one pooled array, so schedule() and cancel() are O(1) and allocation
+// free once the pool has grown; advance() touches only occupied slots,
+// found through a per-level occupancy bitmap. Single-threaded.
+class TimingWheel {
+public:
+    using TimerId = uint64_t;             // 0 is never a valid timer
+
+    struct Fired {
+        TimerId id;
+        uint16_t kind;                    // Caller's tag
+        uint64_t payload;
+    };
+
+    explicit TimingWheel(uint64_t nowMs = 0);
+
+    // Fire 'delayMs' from the wheel's current time (delays past the top level are clamped)
+    TimerId schedule(uint64_t delayMs, uint16_t kind, uint64_t payload = 0);
+    // False if the timer already fired or was cancelled
+    bool cancel(TimerId id);
+    bool pending(TimerId id) const;
+
+    // Move time forward to 'nowMs' and append every timer that came due to 'out'
+    // (in expiry order). Timers scheduled from the results start from 'nowMs'.
+    size_t advance(uint64_t nowMs, std::vector<Fired>& out);
+
+    // Milliseconds from the wheel's time to the next slot that may hold a due
+    // timer, capped at 'limit'. Conservative: a cascade counts as due.
+    uint64_t nextDueMs(uint64_t limit) const;
+
+    uint64_t now() const { return m_now; }
+    size_t size() const { return m_count; }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t NIL = 0xFFFFFFFF;
+
+    struct Node {
+        uint64_t expiry = 0;
+        uint64_t payload = 0;
+        uint32_t prev = NIL, next = NIL;
+        uint32_t generation = 0;
+        uint16_t kind = 0;
+        uint16_t slot = 0xFFFF;           // level * SLOTS + index, 0xFFFF when free
+    };
+
+    void link(uint32_t n);
+    void unlink(uint32_t n);
+    void cascade(int level);
+    int nextOccupied(int level, uint32_t from) const;
+
+    std::vector<Node> m_nodes;
+    uint32_t m_free = NIL;
+    uint32_t m_heads[LEVELS * SLOTS];
+    uint64_t m_occupied[LEVELS][SLOTS / 64] = {};
+    uint64_t m_now = 0;
+    size_t m_count = 0;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef TRACK_FUSION_HPP
+#define TRACK_FUSION_HPP
+
+#include "TrackStore.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Associates sensor tracks (one TrackStore) with multi-sensor fused tracks
+// (a second TrackStore, TRACK_FUSED keys). A sensor track keeps its fused
+// track while the two stay consistent; otherwise it is matched again:
+// first on its 24-bit address, then on a discrete Mode 3/A code, then on
+// position through a uniform lat/lon grid of fused tracks, searching only
+// the 3x3 cells around it. A sensor track that matches nothing starts a
+// new fused track. The grid is rebuilt periodically (rebuild()); tracks
+// created since are searched from a short list, so every association
+// costs O(1) expected and a rebuild O(n log n).
+class TrackFusion {
+public:
+    // Fold sensor track 'row' (just updated, position valid at 'now') into
+    // its fused track, creating one if needed. Returns the fused row;
+    // '*created' is set when it is new.
+    size_t associate(TrackStore& sensors, size_t row, TrackStore& fused, double now, bool* created);
+
+    // Re-index the fused tracks at their positions extrapolated to 'now'
+    void rebuild(const TrackStore& fused, double now);
+
+    // Codes shared by many aircraft (conspicuity, VFR, unassigned) identify nothing
+    static bool discreteMode3A(uint16_t code);
+
+    static constexpr double GATE_M = 2000.0;        // Position gate between different sensors
+    static constexpr double KEEP_GATE_M = 5000.0;   // An existing association survives up to this
+    static constexpr double IDENTITY_GATE_M = 30000.0;  // Same address: only gross errors split
+    static constexpr double GRID_DEG = 0.1;         // Cell size, well over the gates at mid latitudes
+
+private:
+    struct Entry {
+        uint64_t cell;
+        uint64_t track;                 // Fused key
+    };
+    struct CellSlot {
+        uint64_t cell = EMPTY_CELL;
+        uint32_t start = 0, count = 0;  // Range of m_entries
+    };
+    struct Identity {
+        uint32_t code;                  // Address or Mode 3/A code
+        uint64_t track;
+        bool operator<(const Identity& o) const { return code < o.code; }
+    };
+    static constexpr uint64_t EMPTY_CELL = ~uint64_t(0);
+
+    static uint64_t cellOf(double lat, double lon, int dLat = 0, int dLon = 0);
+    size_t slotOf(uint64_t cell) const { return size_t((cell * 0x9E3779B97F4A7C15ull) >> m_shift); }
+    const CellSlot* findCell(uint64_t cell) const;
+
+    long candidate(const TrackStore& sensors, size_t row, const TrackStore& fused, uint64_t key,
+                   double now, double gate, double& bestDistance) const;
+    bool sameSensorMember(const TrackStore& sensors, size_t row, const TrackStore& fused, size_t fusedRow) const;
+    void fold(TrackStore& sensors, size_t row, TrackStore& fused, size_t fusedRow, double now);
+
+    std::vector<Entry> m_entries;        // Sorted by cell
+    std::vector<CellSlot> m_cells;       // Open addressing: cell -> range
+    unsigned m_shift = 64;
+    std::vector<Identity> m_byAddress;   // Sorted
+    std::vector<Identity> m_byMode3A;    // Sorted, discrete codes only
+    std::vector<uint64_t> m_recent;      // Fused tracks created since the last rebuild
+    uint32_t m_nextId = 0;
+};
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef TRACK_STORE_HPP
+#define TRACK_STORE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// What the number in a track key is
+enum TrackKind : uint8_t {
+    TRACK_SENSOR  = 1,   // Track number of one radar/MLAT system (CAT048, CAT020, EK)
+    TRACK_SYSTEM  = 2,   // SDPS system track number (CAT062)
+    TRACK_ADDRESS = 3,   // 24-bit ICAO address, source-independent (CAT021, CAT020)
+    TRACK_FUSED   = 4    // Multi-sensor track built by TrackFusion (SAC/SIC 0)
+};
+
+enum TrackFlag : uint8_t {
+    TRK_POSITION     = 1u << 0,   // lat/lon
+    TRK_VELOCITY     = 1u << 1,   // vx/vy
+    TRK_FLIGHT_LEVEL = 1u << 2,
+    TRK_ADDRESS      = 1u << 3,   // 24-bit address known
+    TRK_MODE3A       = 1u << 4
+};
+
+// Live track picture, one row per (kind, SAC, SIC, number). Rows are dense
+// structure-of-arrays columns, so a pass over every track (CoT, expiry,
+// export) reads contiguous memory; a flat open-addressing index maps keys
+// to rows. Removal moves the last row into the hole, keeping rows dense.
+// Not thread-safe: the owner serialises access.
+class TrackStore {
+public:
+    static uint64_t key(TrackKind kind, uint8_t sac, uint8_t sic, uint32_t number) {
+        return uint64_t(kind) << 48 | uint64_t(sac) << 40 | uint64_t(sic) << 32 | number;
+    }
+    static TrackKind kindOf(uint64_t key) { return TrackKind(key >> 48); }
+    static uint8_t sacOf(uint64_t key) { return uint8_t(key >> 40); }
+    static uint8_t sicOf(uint64_t key) { return uint8_t(key >> 32); }
+    static uint32_t numberOf(uint64_t key) { return uint32_t(key); }
+
+    explicit TrackStore(size_t capacity = 1024);
+
+    // Row of 'key', created (zeroed) if new, which sets '*created'; lastUpdate
+    // is set to 'now'. Rows move on erase(), so hold on to keys, not row numbers.
+    size_t upsert(uint64_t key, double now, bool* created = nullptr);
+    // Row of 'key', -1 if it is not tracked
+    long find(uint64_t key) const;
+
+    // Expiry is the owner's (it knows when to look): drop one track
+    bool erase(uint64_t key);
+    void clear();
+    size_t size() const { return count; }
+
+    // CoT uid: "GNE-TRK-<sac>-<sic>-<tn>", "GNE-SYS-...", "GNE-ICAO-<address>" or "GNE-FUS-<n>"
+    void uid(size_t row, char* out, size_t len) const;
+
+    // --- FILTER ---
+    // Degrees of latitude per metre north, on the filter's spherical earth
+    static constexpr double DEG_PER_M = 180.0 / (3.14159265358979323846 * 6371000.0);
+
+    // Alpha-beta filter on lat/lon and vx/vy. A position measured at 't'
+    // (seconds, the lastUpdate clock) corrects the state extrapolated to
+    // 't'; 'velocity' (vx, vy in m/s) is the sensor's own estimate if the
+    // report has one and replaces the filter's, null otherwise.
+    void filterUpdate(size_t row, double measLat, double measLon, double t, const double* velocity);
+    // One track's state extrapolated to 'now' at constant velocity
+    void positionAt(size_t row, double now, double& outLat, double& outLon) const {
+        double dt = now - stateTime[row];
+        outLat = lat[row] + vy[row] * dt * DEG_PER_M;
+        outLon = lon[row] + vx[row] * dt * lonScale[row];
+    }
+    // positionAt() for every track, into predLat/predLon
+    void predict(double now);
+    // Instruction set predict() runs with, see SimdLevel.hpp
+    static const char* kernel();
+
+    // --- COLUMNS --- rows [0, count)
+    size_t count = 0;
+    std::vector<uint64_t> trackKey;
+    std::vector<uint8_t> flags;         // TrackFlag
+    std::vector<uint8_t> category;      // Of the last report
+    std::vector<uint8_t> quality;       // Updates received, saturating at 255
+    std::vector<double> lastUpdate;     // Caller's clock, seconds
+    std::vector<double> timeOfDay;      // Of the last report, negative if unknown
+    std::vector<double> lat, lon;       // Filtered position, valid at stateTime
+    std::vector<double> vx, vy;         // m/s, x east / y north
+    std::vector<double> stateTime;      // Time of the filter state (lastUpdate clock)
+    std::vector<double> lonScale;       // Degrees of longitude per metre east at 'lat'
+    std::vector<double> predLat, predLon;   // Filled by predict()
+    std::vector<double> flightLevel;
+    std::vector<uint32_t> address;      // TRK_ADDRESS
+    std::vector<uint16_t> mode3A;       // TRK_MODE3A, octal code as a 12-bit value
+    std::vector<uint64_t> link;         // Sensor track: key of its fused track, 0 if none
+    std::vector<uint64_t> members;      // Fused track: MAX_MEMBERS sensor keys per row, 0 = free
+    std::vector<char> label;            // LABEL_LEN per row: the id shown for the track
+    std::vector<char> callsign;         // CALLSIGN_LEN per row, empty until identified
+
+    static constexpr size_t LABEL_LEN = 16;
+    static constexpr size_t CALLSIGN_LEN = 9;
+    static constexpr size_t MAX_MEMBERS = 4;
+    char* labelOf(size_t row) { return &label[row * LABEL_LEN]; }
+    const char* labelOf(size_t row) const { return &label[row * LABEL_LEN]; }
+    char* callsignOf(size_t row) { return &callsign[row * CALLSIGN_LEN]; }
+    const char* callsignOf(size_t row) const { return &callsign[row * CALLSIGN_LEN]; }
+    uint64_t* membersOf(size_t row) { return &members[row * MAX_MEMBERS]; }
+    const uint64_t* membersOf(size_t row) const { return &members[row * MAX_MEMBERS]; }
+
+private:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFF;
+
+    size_t slotOf(uint64_t k) const { return size_t((k * 0x9E3779B97F4A7C15ull) >> m_shift); }
+    size_t slotOfRow(size_t row) const;
+    void resizeRows(size_t n);
+    void growIndex();
+    void eraseSlot(size_t slot);
+    void remove(size_t row);
+
+    std::vector<uint32_t> m_index;      // Slot -> row, EMPTY if free
+    size_t m_mask = 0;
+    unsigned m_shift = 0;
+};
+
+#endif
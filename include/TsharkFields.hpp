@@ -0,0 +1,61 @@
+#ifndef TSHARK_FIELDS_HPP
+#define TSHARK_FIELDS_HPP
+
+#include "AsterixDecoder.hpp"
+#include "AsterixMapping.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Reduced-field tshark mode: instead of "-T ek" (every dissected field as
+// JSON) tshark prints only the columns we use, tab separated, and this class
+// maps each column back onto the native decoder's records by position.
+class TsharkFields {
+public:
+    // What a column fills in the decoded record
+    enum Role : uint8_t {
+        ROLE_NONE = 0,       // Mapped for the web feed only
+        ROLE_SAC, ROLE_SIC,
+        ROLE_TIME,
+        ROLE_MESSAGE_TYPE,
+        ROLE_LAT, ROLE_LON, ROLE_HEIGHT,
+        ROLE_RHO, ROLE_THETA,
+        ROLE_TRACK_NUMBER,
+        ROLE_X, ROLE_Y,
+        ROLE_GROUND_SPEED, ROLE_HEADING,
+        ROLE_REPORT_TYPE,
+        ROLE_TRACK_STATUS
+    };
+
+    struct Column {
+        std::string field;     // tshark field name, e.g. "asterix.048_040_RHO"
+        Role role = ROLE_NONE;
+        uint8_t category = 0;  // 34/48 from the field name, 0 if generic
+    };
+
+    // Columns = the fields the live pipeline needs + every mapping source.
+    // 'known' (from "tshark -G fields") drops names this tshark does not
+    // have, since one unknown -e aborts tshark; empty means accept all.
+    void configure(const std::vector<AsterixMapping>& mapping, const std::vector<std::string>& known);
+
+    // Field names known to the installed tshark (empty if it cannot be run)
+    static std::vector<std::string> queryKnownFields();
+
+    // "-T fields -E separator=/t -E occurrence=a -E aggregator=, -e ... -e ..."
+    std::string tsharkArgs() const;
+    const std::vector<Column>& columns() const { return m_columns; }
+
+    // Positional parse of one output line (one datagram). Every occurrence of
+    // a CAT034/CAT048 column goes to the record with the same index in that
+    // category, so a data block of N plots appends N records. Items that only
+    // some records carry cannot be placed exactly and fill the first ones.
+    // Returns the number of records appended.
+    size_t parse(const char* line, size_t len, std::vector<Cat034Record>& c034,
+                 std::vector<Cat048Record>& c048) const;
+
+private:
+    std::vector<Column> m_columns;
+};
+
+#endif
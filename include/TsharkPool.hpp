@@ -0,0 +1,76 @@
+#ifndef TSHARK_POOL_HPP
+#define TSHARK_POOL_HPP
+
+#include "PipeReader.hpp"
+#include "PacketPool.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <cstdint>
+#include <sys/types.h>
+
+// N long-lived "tshark -r -" workers fed a pcap stream on stdin. We capture
+// once, hand each datagram to one worker and merge their output back into
+// capture order: every packet produces exactly one output line, so each
+// worker's lines match the sequence numbers it was given, in order.
+class TsharkPool {
+public:
+    enum class Dispatch { RoundRobin, SacSic };
+    using LineHandler = PipeReader::LineHandler;
+
+    TsharkPool() = default;
+    ~TsharkPool();
+    TsharkPool(const TsharkPool&) = delete;
+    TsharkPool& operator=(const TsharkPool&) = delete;
+
+    // 'outputArgs' selects the output format ("-T ek" or the fields list);
+    // EK index lines are skipped when 'ekOutput' is set.
+    bool start(int workers, int port, const std::string& outputArgs, bool ekOutput, Dispatch dispatch);
+    void stop();
+    size_t workerCount() const { return m_workers.size(); }
+    bool anyAlive() const;
+
+    // Queue one ASTERIX payload for dissection (wrapped as IPv4/UDP to 'port').
+    // 'payload' is pkt's own or a filtered copy of it; pkt gives the timestamp.
+    void submit(const PacketRef& pkt, const uint8_t* payload, uint32_t payloadLen);
+
+    // Service worker pipes for up to timeoutMs ('wakeFd', if >= 0, ends the
+    // wait early and is drained). Lines are delivered in capture order.
+    int poll(int timeoutMs, int wakeFd, const LineHandler& onLine);
+
+    // Packets dropped because a worker fell behind or exited
+    uint64_t dropped() const { return m_dropped; }
+
+private:
+    struct Worker {
+        pid_t pid = -1;
+        int in = -1;                 // tshark stdin (non-blocking)
+        PipeReader out;              // tshark stdout
+        std::string pending;         // pcap bytes not yet taken by the pipe
+        std::deque<uint64_t> seqs;   // Submitted, waiting for their line
+    };
+
+    bool spawn(Worker& w, const std::string& cmd);
+    void flush(Worker& w);
+    void retire(Worker& w);
+    size_t pick(const uint8_t* p, uint32_t len);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    Dispatch m_dispatch = Dispatch::RoundRobin;
+    bool m_ekOutput = true;
+    int m_port = 0;
+    size_t m_next = 0;
+
+    // Reordering: finished lines keyed by sequence; empty string = lost
+    uint64_t m_submitSeq = 0;
+    uint64_t m_emitSeq = 0;
+    std::map<uint64_t, std::string> m_done;
+    std::string m_scratch;
+    uint64_t m_dropped = 0;
+
+    static constexpr size_t MAX_PENDING = 8 * 1024 * 1024;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef UAP_SPEC_HPP
+#define UAP_SPEC_HPP
+
+#include "AsterixDecoder.hpp"
+#include "AsterixMapping.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// UAP definitions loaded at startup (resources/asterix_spec.json), for the
+// categories and editions the built-in decoders do not cover. Items of every
+// edition live in one flat UapItem array so AsterixDecoder::walkRecord() can
+// locate them; their fields sit in a second flat array, read only for items
+// that are enabled.
+//
+// {"categories": [{"category": 2, "default_edition": "1.0",
+//   "sources": [{"sac": 25, "sic": 1, "edition": "1.0"}],
+//   "editions": [{"edition": "1.0", "uap": [
+//     {"id": "010", "type": "fixed", "len": 2,
+//      "fields": [{"name": "SAC", "bits": 8}, {"name": "SIC", "bits": 8}]},
+//     {"id": "030", "type": "fixed", "len": 3, "fields": [{"name": "VALUE", "bits": 24, "scale": 0.0078125}]},
+//     {"id": "050", "type": "extended", "len": 1, "ext": 1, "decode": false}, ...]}]}]}
+//
+// Fields are laid out MSB first from the start of the item (after the REP or
+// length octet for repetitive/explicit items); unnamed fields are spare bits.
+// A field is published as "CCC_III_NAME", the tshark naming the mapping file uses.
+class UapSpec {
+public:
+    UapSpec();
+    bool load(const std::string& path);
+
+    // Restrict decoding to the items the mapping file names (I010 is always
+    // kept). Categories the mapping does not mention are left as loaded.
+    void bindMapping(const AsterixConfigParser& mapping);
+
+    // Categories with at least one edition
+    bool hasCategory(uint8_t cat) const { return m_defaultEdition[cat] >= 0; }
+    // Edition configured for one source, or -1 (then the default applies)
+    int sourceEdition(uint8_t cat, uint8_t sac, uint8_t sic) const;
+    bool hasSources(uint8_t cat) const { return m_hasSources[cat]; }
+
+    // Decode one record with the source's edition ('edition' < 0 selects it
+    // from I010). Returns a pointer just past the record, or nullptr.
+    const uint8_t* decodeRecord(uint8_t cat, const uint8_t* p, const uint8_t* end,
+                                AsterixDecodeResult& out, int edition = -1) const;
+
+    const std::string& fieldName(uint32_t field) const { return m_names[m_fields[field].name]; }
+
+private:
+    struct Field {
+        uint32_t name = 0;          // Index into m_names
+        uint16_t bitOffset = 0;
+        uint8_t bits = 0;
+        bool isSigned = false;
+        double scale = 1.0;
+    };
+    // Parallel to m_layout
+    struct ItemInfo {
+        uint32_t firstField = 0;
+        uint16_t fieldCount = 0;
+        bool enabled = true;
+        bool source = false;        // I010: SAC/SIC
+    };
+    struct Edition {
+        uint8_t category = 0;
+        std::string name;
+        uint32_t firstItem = 0;     // Top-level items, indexed by FRN - 1
+        uint8_t count = 0;
+    };
+
+    bool parseItem(const nlohmann::json& j, uint8_t cat, const std::string& itemId, uint32_t index,
+                   std::vector<uint32_t>& subIndex);
+    void emitFields(uint32_t item, const uint8_t* p, size_t len, AsterixDecodeResult& out) const;
+    void emitItem(uint32_t item, const uint8_t* p, size_t len, AsterixDecodeResult& out) const;
+
+    std::vector<UapItem> m_layout;      // Every item and compound subfield
+    std::vector<ItemInfo> m_items;
+    std::vector<Field> m_fields;
+    std::vector<std::string> m_names;
+    std::vector<Edition> m_editions;
+    std::vector<UapTable> m_tables;     // Parallel to m_editions
+    std::vector<std::pair<uint32_t, uint16_t>> m_sources;   // (cat << 16 | sac << 8 | sic) -> edition, sorted
+    int16_t m_defaultEdition[256];
+    bool m_hasSources[256] = {};
+};
+
+#endif
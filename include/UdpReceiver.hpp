@@ -0,0 +1,67 @@
+#ifndef UDP_RECEIVER_HPP
+#define UDP_RECEIVER_HPP
+
+#include "PacketPool.hpp"
+#include "BpfFilter.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+// Batched UDP ingest: one recvmmsg() drains up to 'batchSize' datagrams
+// straight into pooled buffers, so a datagram is never copied in user space.
+class UdpReceiver {
+public:
+    struct Options {
+        std::string interface;      // Used for the multicast join ("any" = kernel choice)
+        int port = 8600;
+        std::string group;          // Multicast group, empty/0.0.0.0 for unicast
+        int batchSize = 64;
+        int rcvBufBytes = 4 * 1024 * 1024;
+        bool reusePort = false;     // SO_REUSEPORT, for inputs sharing a port
+    };
+
+    UdpReceiver() = default;
+    ~UdpReceiver();
+    UdpReceiver(const UdpReceiver&) = delete;
+    UdpReceiver& operator=(const UdpReceiver&) = delete;
+
+    bool open(const Options& opts, PacketPool& pool);
+
+    // Kernel-side ASTERIX filter; an empty select removes it. Callable from
+    // any thread while receive() runs (the kernel swaps programs atomically).
+    bool setFilter(const AsterixSelect& select);
+    void close();
+    bool isOpen() const { return m_sock != -1; }
+    int fd() const { return m_sock; }
+
+    // Wait up to timeoutMs for traffic, then drain one batch.
+    // Returns the number of slots filled (0 on timeout, -1 on error).
+    int receive(int timeoutMs);
+
+    // Hand datagram i to the caller (empty if it was truncated and dropped)
+    PacketRef take(int i);
+    const sockaddr_in& source(int i) const { return m_addrs[i]; }
+
+    // Counters
+    uint64_t datagrams() const { return m_datagrams; }
+    uint64_t truncated() const { return m_truncated; }
+
+private:
+    Options m_opts;
+    PacketPool* m_pool = nullptr;
+    int m_sock = -1;
+
+    // One entry per batch slot; slots keep their buffer until take()
+    std::vector<PacketRef> m_slots;
+    std::vector<iovec> m_iovs;
+    std::vector<mmsghdr> m_msgs;
+    std::vector<sockaddr_in> m_addrs;
+
+    uint64_t m_datagrams = 0;
+    uint64_t m_truncated = 0;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef VIDEO_RASTER_HPP
+#define VIDEO_RASTER_HPP
+
+#include "AsterixDecoder.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Plan position indicator built from CAT240 video messages. Cells are
+// accumulated into a square, sensor-centred raster (north up) and served
+// as web map tiles.
+//
+// Every raster pixel belongs to exactly one azimuth bin; the per-bin lists
+// of (pixel, range bin) are built once, so a video message only resamples
+// its cells into one row of range bins and copies that row along the bins
+// it covers. update() runs on a single thread; tilePng() may be called
+// from any thread.
+//
+// The raster shows one radar: the first source (SAC/SIC) whose video it
+// sees. It is placed at that radar's own site, once setOrigin() has
+// reported it; video from other sources is counted and dropped.
+class VideoRaster {
+public:
+    // 'size' pixels across; 'azimuthBins' azimuth lookup tables
+    explicit VideoRaster(int size = 1024, int azimuthBins = 4096);
+
+    // Radius covered by the raster. Clears it.
+    void setRange(double rangeM);
+    // Site of radar sac/sic (CAT034 I120); any number of radars may report
+    void setOrigin(uint8_t sac, uint8_t sic, double lat, double lon);
+    bool hasOrigin() const;
+
+    // Blend one video message (I000 = 2) into the raster.
+    // Returns false if it carries no usable cells.
+    bool update(const Cat240Record& r);
+
+    // Render web map tile z/x/y (256 px, Web Mercator) as an RGBA PNG.
+    // False until the sensor position is known.
+    bool tilePng(int z, int x, int y, std::string& png) const;
+
+    struct Stats {
+        uint64_t messages = 0;
+        uint64_t cells = 0;
+        uint64_t rejected = 0;    // Malformed, or compressed data that did not inflate
+        uint64_t otherSource = 0; // Video from a radar other than the one shown
+    };
+    Stats stats() const;
+
+private:
+    void buildLut();
+    // Cells as 8-bit intensities; returns the cell count or 0
+    size_t expandCells(const Cat240Record& r, const uint8_t*& cells);
+    void resampleRow(const Cat240Record& r, const uint8_t* cells, size_t count, double rangeM);
+    static void encodePng(const std::vector<uint8_t>& rgba, int w, int h, std::string& out);
+
+    int m_size;
+    int m_radius;                       // Range bins per row (m_size / 2)
+    int m_azBins;
+
+    // Per-azimuth lookup: pixels of bin a are [m_azStart[a], m_azStart[a + 1])
+    std::vector<uint32_t> m_azStart;
+    std::vector<uint32_t> m_lutPixel;
+    std::vector<uint16_t> m_lutBin;
+
+    // Update scratch (update() thread only)
+    std::vector<uint8_t> m_inflated;
+    std::vector<uint8_t> m_cells;
+    std::vector<uint8_t> m_row;
+
+    mutable std::mutex m_mutex;         // Guards everything below
+    std::vector<uint8_t> m_pixels;      // Intensity, row-major from the north-west corner
+    double m_rangeM = 60000.0;
+    int m_source = -1;                  // sac << 8 | sic of the radar shown, -1 until bound
+    double m_lat = 0.0, m_lon = 0.0;    // Its site
+    bool m_hasOrigin = false;
+    struct Site {
+        uint16_t source;
+        double lat, lon;
+    };
+    std::vector<Site> m_sites;          // Every radar site reported so far
+
+    std::atomic<uint64_t> m_messages{0};
+    std::atomic<uint64_t> m_cellCount{0};
+    std::atomic<uint64_t> m_rejected{0};
+    std::atomic<uint64_t> m_otherSource{0};
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef WEB_FEED_HPP
+#define WEB_FEED_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+enum WebRecordFlag : uint16_t {
+    WEB_SOURCE       = 1u << 0,   // sac/sic
+    WEB_TIME         = 1u << 1,   // timeOfDay
+    WEB_GEO          = 1u << 2,   // lat/lon
+    WEB_POLAR        = 1u << 3,   // rho/theta
+    WEB_VELOCITY     = 1u << 4,   // speed/heading
+    WEB_FLIGHT_LEVEL = 1u << 5,
+    WEB_DROPPED      = 1u << 6    // Track 'uid' expired: nothing else is set
+};
+
+// One target report as the web map sees it, whatever decoder produced it.
+// Fixed size and trivially copyable: the feed stores these by value.
+struct WebRecord {
+    static constexpr int MAX_EXTRAS = 6;
+
+    struct Extra {
+        const char* name;         // Static, or owned by the engine's UapSpec
+        double value;
+    };
+
+    uint8_t category = 0;
+    uint8_t sac = 0, sic = 0;
+    uint8_t extraCount = 0;
+    uint16_t flags = 0;           // WebRecordFlag
+    double timeOfDay = 0.0;       // Seconds since midnight UTC
+    double lat = 0.0, lon = 0.0;
+    double rho = 0.0, theta = 0.0;  // NM, degrees
+    double speed = 0.0;           // m/s
+    double heading = 0.0;         // Degrees true
+    double flightLevel = 0.0;
+    char id[16] = {};             // Track number or address, empty if none
+    char uid[32] = {};            // TrackStore uid, empty for plots outside a track
+    char callsign[9] = {};
+    Extra extras[MAX_EXTRAS];     // Further values (spec-decoded categories)
+};
+static_assert(std::is_trivially_copyable<WebRecord>::value, "WebFeed copies records with memcpy");
+
+// Records waiting for the next /api/data poll. A preallocated ring: when
+// the browser falls behind the oldest records are overwritten, and neither
+// push() nor drain() allocates once the output string has grown.
+class WebFeed {
+public:
+    explicit WebFeed(size_t capacity = 2048);
+
+    void push(const WebRecord& r);
+
+    // Replace 'out' with the pending records as a JSON array and empty the
+    // ring. Returns the number of records written.
+    size_t drain(std::string& out);
+
+    uint64_t overwritten() const;
+
+private:
+    static void append(const WebRecord& r, std::string& out);
+
+    mutable std::mutex m_mutex;        // Guards the ring
+    std::vector<WebRecord> m_ring;
+    size_t m_head = 0;                 // Oldest record
+    size_t m_count = 0;
+    uint64_t m_overwritten = 0;
+
+    std::mutex m_drainMutex;           // One drain at a time owns the snapshot
+    std::vector<WebRecord> m_snapshot;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "AdsbTable.hpp"
+
+AdsbTable::AdsbTable(size_t capacity) {
+    size_t n = 64;
+    while (n < capacity) n <<= 1;
+    m_slots.assign(n, Entry());
+    m_mask = n - 1;
+    m_shift = 32;
+    for (size_t v = n; v > 1; v >>= 1) m_shift--;
+}
+
+AdsbTable::Entry& AdsbTable::upsert(uint32_t address, double now) {
+    // Keep the load factor under 3/4 so probe runs stay short
+    if ((m_count + 1) * 4 > m_slots.size() * 3) grow();
+
+    size_t i = slotOf(address);
+    while (m_slots[i].address != EMPTY && m_slots[i].address != address) i = (i + 1) & m_mask;
+    Entry& e = m_slots[i];
+    if (e.address == EMPTY) {
+        e = Entry();
+        e.address = address;
+        m_count++;
+    }
+    e.lastSeen = now;
+    return e;
+}
+
+const AdsbTable::Entry* AdsbTable::find(uint32_t address) const {
+    for (size_t i = slotOf(address);; i = (i + 1) & m_mask) {
+        if (m_slots[i].address == address) return &m_slots[i];
+        if (m_slots[i].address == EMPTY) return nullptr;
+    }
+}
+
+void AdsbTable::grow() {
+    std::vector<Entry> old;
+    old.swap(m_slots);
+    m_slots.assign(old.size() * 2, Entry());
+    m_mask = m_slots.size() - 1;
+    m_shift--;
+    for (const Entry& e : old) {
+        if (e.address == EMPTY) continue;
+        size_t i = slotOf(e.address);
+        while (m_slots[i].address != EMPTY) i = (i + 1) & m_mask;
+        m_slots[i] = e;
+    }
+}
+
+// Backward-shift deletion: no tombstones, so lookups never slow down over time
+void AdsbTable::erase(size_t slot) {
+    size_t hole = slot;
+    for (size_t i = (slot + 1) & m_mask; m_slots[i].address != EMPTY; i = (i + 1) & m_mask) {
+        size_t home = slotOf(m_slots[i].address);
+        // Move the entry back if the hole lies between its home slot and where it sits
+        if (((i - home) & m_mask) >= ((i - hole) & m_mask)) {
+            m_slots[hole] = m_slots[i];
+            hole = i;
+        }
+    }
+    m_slots[hole] = Entry();
+    m_count--;
+}
+
+size_t AdsbTable::expire(double now, double maxAge) {
+    size_t dropped = 0;
+    for (size_t i = 0; i < m_slots.size();) {
+        if (m_slots[i].address != EMPTY && now - m_slots[i].lastSeen > maxAge) {
+            // The shift may pull another entry into slot i: look at it again
+            erase(i);
+            dropped++;
+            continue;
+        }
+        ++i;
+    }
+    return dropped;
+}
@@ -0,0 +1,1106 @@
+#include "AsterixDecoder.hpp"
+#include "UapSpec.hpp"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// --- BYTE HELPERS (ASTERIX is big-endian) ---
+static inline uint32_t u16(const uint8_t* p) { return (uint32_t(p[0]) << 8) | p[1]; }
+static inline uint32_t u24(const uint8_t* p) { return (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2]; }
+static inline int32_t s16(const uint8_t* p) { return int16_t(u16(p)); }
+static inline int32_t s24(const uint8_t* p) { int32_t v = int32_t(u24(p)); return (v & 0x800000) ? v - 0x1000000 : v; }
+
+// --- UAP TABLES ---
+// Shorthands so the tables below read like the spec
+static constexpr UapItem SPARE{};
+static constexpr UapItem fixed(uint16_t id, uint16_t len) { return {id, UapItemType::Fixed, len, 0, nullptr, 0}; }
+static constexpr UapItem extended(uint16_t id, uint8_t len, uint8_t ext) { return {id, UapItemType::Extended, len, ext, nullptr, 0}; }
+static constexpr UapItem repetitive(uint16_t id, uint16_t len) { return {id, UapItemType::Repetitive, len, 0, nullptr, 0}; }
+static constexpr UapItem explicitItem(uint16_t id) { return {id, UapItemType::Explicit, 0, 0, nullptr, 0}; }
+static constexpr UapItem compound(uint16_t id, const UapItem* sub, uint8_t n) { return {id, UapItemType::Compound, 0, 0, sub, n}; }
+
+// CAT048 I130 Radar Plot Characteristics: SRL, SRR, SAM, PRL, PAM, RPD, APD
+static constexpr UapItem CAT048_I130[] = {
+    fixed(1, 1), fixed(2, 1), fixed(3, 1), fixed(4, 1), fixed(5, 1), fixed(6, 1), fixed(7, 1)
+};
+// CAT048 I120 Radial Doppler Speed: CAL, RDS
+static constexpr UapItem CAT048_I120[] = { fixed(1, 2), repetitive(2, 6) };
+
+static constexpr UapItem CAT048_UAP[] = {
+    fixed(10, 2),       // FRN 1
+    fixed(140, 3),
+    extended(20, 1, 1),
+    fixed(40, 4),
+    fixed(70, 2),
+    fixed(90, 2),
+    compound(130, CAT048_I130, 7),
+    fixed(220, 3),      // FRN 8
+    fixed(240, 6),
+    repetitive(250, 8),
+    fixed(161, 2),
+    fixed(42, 4),
+    fixed(200, 4),
+    extended(170, 1, 1),
+    fixed(210, 4),      // FRN 15
+    extended(30, 1, 1),
+    fixed(80, 2),
+    fixed(100, 4),
+    fixed(110, 2),
+    compound(120, CAT048_I120, 2),
+    fixed(230, 2),
+    fixed(260, 7),      // FRN 22
+    fixed(55, 1),
+    fixed(50, 2),
+    fixed(65, 1),
+    fixed(60, 2),
+    explicitItem(0),    // SP
+    explicitItem(0)     // RE
+};
+
+// CAT034 I050 System Configuration Status: COM, -, -, PSR, SSR, MDS
+static constexpr UapItem CAT034_I050[] = { fixed(1, 1), SPARE, SPARE, fixed(4, 1), fixed(5, 1), fixed(6, 2) };
+// CAT034 I060 System Processing Mode: COM, -, -, PSR, SSR, MDS
+static constexpr UapItem CAT034_I060[] = { fixed(1, 1), SPARE, SPARE, fixed(4, 1), fixed(5, 1), fixed(6, 1) };
+
+static constexpr UapItem CAT034_UAP[] = {
+    fixed(10, 2),       // FRN 1
+    fixed(0, 1),
+    fixed(30, 3),
+    fixed(20, 1),
+    fixed(41, 2),
+    compound(50, CAT034_I050, 6),
+    compound(60, CAT034_I060, 6),
+    repetitive(70, 2),  // FRN 8
+    fixed(100, 8),
+    fixed(110, 1),
+    fixed(120, 8),
+    fixed(90, 2),
+    explicitItem(0),    // RE
+    explicitItem(0)     // SP
+};
+
+// CAT021 I220 Met Information: WS, WD, TMP, TRB
+static constexpr UapItem CAT021_I220[] = { fixed(1, 2), fixed(2, 2), fixed(3, 2), fixed(4, 1) };
+// CAT021 I110 Trajectory Intent: TIS, TID
+static constexpr UapItem CAT021_I110[] = { extended(1, 1, 1), repetitive(2, 15) };
+// CAT021 I295 Data Ages: one octet per subfield (AOS ... SCC)
+static constexpr UapItem CAT021_I295[] = {
+    fixed(1, 1), fixed(2, 1), fixed(3, 1), fixed(4, 1), fixed(5, 1), fixed(6, 1), fixed(7, 1),
+    fixed(8, 1), fixed(9, 1), fixed(10, 1), fixed(11, 1), fixed(12, 1), fixed(13, 1), fixed(14, 1),
+    fixed(15, 1), fixed(16, 1), fixed(17, 1), fixed(18, 1), fixed(19, 1), fixed(20, 1), fixed(21, 1),
+    fixed(22, 1), fixed(23, 1)
+};
+
+// CAT021 edition 2.1
+static constexpr UapItem CAT021_UAP[] = {
+    fixed(10, 2),       // FRN 1
+    extended(40, 1, 1),
+    fixed(161, 2),
+    fixed(15, 1),
+    fixed(71, 3),
+    fixed(130, 6),
+    fixed(131, 8),
+    fixed(72, 3),       // FRN 8
+    fixed(150, 2),
+    fixed(151, 2),
+    fixed(80, 3),
+    fixed(73, 3),
+    fixed(74, 4),
+    fixed(75, 3),
+    fixed(76, 4),       // FRN 15
+    fixed(140, 2),
+    extended(90, 1, 1),
+    fixed(210, 1),
+    fixed(70, 2),
+    fixed(230, 2),
+    fixed(145, 2),
+    fixed(152, 2),      // FRN 22
+    fixed(200, 1),
+    fixed(155, 2),
+    fixed(157, 2),
+    fixed(160, 4),
+    fixed(165, 2),
+    fixed(77, 3),
+    fixed(170, 6),      // FRN 29
+    fixed(20, 1),
+    compound(220, CAT021_I220, 4),
+    fixed(146, 2),
+    fixed(148, 2),
+    compound(110, CAT021_I110, 2),
+    fixed(16, 1),
+    fixed(8, 1),        // FRN 36
+    extended(271, 1, 1),
+    fixed(132, 1),
+    repetitive(250, 8),
+    fixed(260, 7),
+    fixed(400, 1),
+    compound(295, CAT021_I295, 23),
+    SPARE,              // FRN 43
+    SPARE,
+    SPARE,
+    SPARE,
+    SPARE,
+    explicitItem(0),    // RE
+    explicitItem(0)     // SP
+};
+
+// CAT062 I380 Aircraft Derived Data: ADR ... BPS
+static constexpr UapItem CAT062_I380[] = {
+    fixed(1, 3), fixed(2, 6), fixed(3, 2), fixed(4, 2), fixed(5, 2), fixed(6, 2), fixed(7, 2),
+    extended(8, 1, 1), repetitive(9, 15), fixed(10, 2), fixed(11, 2), fixed(12, 7), fixed(13, 2), fixed(14, 2),
+    fixed(15, 2), fixed(16, 2), fixed(17, 2), fixed(18, 2), fixed(19, 1), fixed(20, 8), fixed(21, 1),
+    fixed(22, 6), fixed(23, 2), fixed(24, 1), repetitive(25, 8), fixed(26, 2), fixed(27, 2), fixed(28, 2)
+};
+// CAT062 I290 System Track Update Ages: TRK, PSR, SSR, MDS, ADS, ES, VDL, UAT, LOP, MLT
+static constexpr UapItem CAT062_I290[] = {
+    fixed(1, 1), fixed(2, 1), fixed(3, 1), fixed(4, 1), fixed(5, 2), fixed(6, 1), fixed(7, 1),
+    fixed(8, 1), fixed(9, 1), fixed(10, 1)
+};
+// CAT062 I295 Track Data Ages: one octet per subfield (MFL ... BPS)
+static constexpr UapItem CAT062_I295[] = {
+    fixed(1, 1), fixed(2, 1), fixed(3, 1), fixed(4, 1), fixed(5, 1), fixed(6, 1), fixed(7, 1),
+    fixed(8, 1), fixed(9, 1), fixed(10, 1), fixed(11, 1), fixed(12, 1), fixed(13, 1), fixed(14, 1),
+    fixed(15, 1), fixed(16, 1), fixed(17, 1), fixed(18, 1), fixed(19, 1), fixed(20, 1), fixed(21, 1),
+    fixed(22, 1), fixed(23, 1), fixed(24, 1), fixed(25, 1), fixed(26, 1), fixed(27, 1), fixed(28, 1),
+    fixed(29, 1), fixed(30, 1), fixed(31, 1)
+};
+// CAT062 I390 Flight Plan Related Data: TAG ... PEC
+static constexpr UapItem CAT062_I390[] = {
+    fixed(1, 2), fixed(2, 7), fixed(3, 4), fixed(4, 1), fixed(5, 4), fixed(6, 1), fixed(7, 4),
+    fixed(8, 4), fixed(9, 3), fixed(10, 2), fixed(11, 2), repetitive(12, 4), fixed(13, 6), fixed(14, 1),
+    fixed(15, 7), fixed(16, 7), fixed(17, 2), fixed(18, 7)
+};
+// CAT062 I110 Mode 5 Data: SUM, PMN, POS, GA, EM1, TOS, XP
+static constexpr UapItem CAT062_I110[] = {
+    fixed(1, 1), fixed(2, 4), fixed(3, 6), fixed(4, 2), fixed(5, 2), fixed(6, 1), fixed(7, 1)
+};
+// CAT062 I500 Estimated Accuracies: APC, COV, APW, AGA, ABA, ATV, AA, ARC
+static constexpr UapItem CAT062_I500[] = {
+    fixed(1, 4), fixed(2, 2), fixed(3, 4), fixed(4, 1), fixed(5, 1), fixed(6, 2), fixed(7, 2), fixed(8, 1)
+};
+// CAT062 I340 Measured Information: SID, POS, HEI, MDC, MDA, TYP
+static constexpr UapItem CAT062_I340[] = {
+    fixed(1, 2), fixed(2, 4), fixed(3, 2), fixed(4, 2), fixed(5, 2), fixed(6, 1)
+};
+
+// CAT062 edition 1.18
+static constexpr UapItem CAT062_UAP[] = {
+    fixed(10, 2),       // FRN 1
+    SPARE,
+    fixed(15, 1),
+    fixed(70, 3),
+    fixed(105, 8),
+    fixed(100, 6),
+    fixed(185, 4),
+    fixed(210, 2),      // FRN 8
+    fixed(60, 2),
+    fixed(245, 7),
+    compound(380, CAT062_I380, 28),
+    fixed(40, 2),
+    extended(80, 1, 1),
+    compound(290, CAT062_I290, 10),
+    fixed(200, 1),      // FRN 15
+    compound(295, CAT062_I295, 31),
+    fixed(136, 2),
+    fixed(130, 2),
+    fixed(135, 2),
+    fixed(220, 2),
+    compound(390, CAT062_I390, 18),
+    extended(270, 1, 1),// FRN 22
+    fixed(300, 1),
+    compound(110, CAT062_I110, 7),
+    fixed(120, 2),
+    extended(510, 3, 3),
+    compound(500, CAT062_I500, 8),
+    compound(340, CAT062_I340, 6),
+    SPARE,              // FRN 29
+    SPARE,
+    SPARE,
+    SPARE,
+    SPARE,
+    explicitItem(0),    // RE
+    explicitItem(0)     // SP
+};
+
+// CAT020 I500 Position Accuracy: DOP, SDP, SDH
+static constexpr UapItem CAT020_I500[] = { fixed(1, 6), fixed(2, 6), fixed(3, 2) };
+
+// CAT020 edition 1.10 (multilateration target reports)
+static constexpr UapItem CAT020_UAP[] = {
+    fixed(10, 2),       // FRN 1
+    extended(20, 1, 1),
+    fixed(140, 3),
+    fixed(41, 8),
+    fixed(42, 6),
+    fixed(161, 2),
+    extended(170, 1, 1),
+    fixed(70, 2),       // FRN 8
+    fixed(202, 4),
+    fixed(90, 2),
+    fixed(100, 4),
+    fixed(220, 3),
+    fixed(245, 7),
+    fixed(110, 2),
+    fixed(105, 2),      // FRN 15
+    fixed(210, 2),
+    fixed(300, 1),
+    fixed(310, 1),
+    compound(500, CAT020_I500, 3),
+    repetitive(400, 1),
+    repetitive(250, 8),
+    fixed(230, 2),      // FRN 22
+    fixed(260, 7),
+    extended(30, 1, 1),
+    fixed(55, 1),
+    fixed(50, 2),
+    explicitItem(0),    // RE
+    explicitItem(0)     // SP
+};
+
+// CAT019 edition 1.3 (multilateration system status)
+static constexpr UapItem CAT019_UAP[] = {
+    fixed(10, 2),       // FRN 1
+    fixed(0, 1),
+    fixed(140, 3),
+    fixed(550, 1),
+    fixed(551, 1),
+    repetitive(552, 2),
+    extended(553, 1, 1),
+    fixed(600, 8),      // FRN 8
+    fixed(610, 2),
+    fixed(620, 1),
+    SPARE,
+    SPARE,
+    explicitItem(0),    // RE
+    explicitItem(0)     // SP
+};
+
+static constexpr UapTable UAP_020{20, CAT020_UAP, sizeof(CAT020_UAP) / sizeof(UapItem)};
+static constexpr UapTable UAP_019{19, CAT019_UAP, sizeof(CAT019_UAP) / sizeof(UapItem)};
+
+// CAT240 edition 1.3 (radar video)
+static constexpr UapItem CAT240_UAP[] = {
+    fixed(10, 2),       // FRN 1
+    fixed(0, 1),
+    fixed(20, 4),
+    repetitive(30, 1),
+    fixed(40, 12),
+    fixed(41, 12),
+    fixed(48, 2),
+    fixed(49, 5),       // FRN 8
+    repetitive(50, 4),
+    repetitive(51, 64),
+    repetitive(52, 256),
+    fixed(140, 3),
+    explicitItem(0),    // RE
+    explicitItem(0)     // SP
+};
+
+static constexpr UapTable UAP_240{240, CAT240_UAP, sizeof(CAT240_UAP) / sizeof(UapItem)};
+static constexpr UapTable UAP_062{62, CAT062_UAP, sizeof(CAT062_UAP) / sizeof(UapItem)};
+static constexpr UapTable UAP_021{21, CAT021_UAP, sizeof(CAT021_UAP) / sizeof(UapItem)};
+static constexpr UapTable UAP_034{34, CAT034_UAP, sizeof(CAT034_UAP) / sizeof(UapItem)};
+static constexpr UapTable UAP_048{48, CAT048_UAP, sizeof(CAT048_UAP) / sizeof(UapItem)};
+
+const UapTable& AsterixDecoder::uapCat034() { return UAP_034; }
+const UapTable& AsterixDecoder::uapCat048() { return UAP_048; }
+const UapTable& AsterixDecoder::uapCat021() { return UAP_021; }
+const UapTable& AsterixDecoder::uapCat062() { return UAP_062; }
+const UapTable& AsterixDecoder::uapCat240() { return UAP_240; }
+const UapTable& AsterixDecoder::uapCat020() { return UAP_020; }
+const UapTable& AsterixDecoder::uapCat019() { return UAP_019; }
+
+// --- GENERIC ITEM WALK ---
+size_t AsterixDecoder::itemLength(const UapItem& it, const uint8_t* p, const uint8_t* end) {
+    size_t avail = end - p;
+    switch (it.type) {
+        case UapItemType::Fixed:
+            return it.len <= avail ? it.len : 0;
+
+        case UapItemType::Extended: {
+            size_t n = it.len;
+            if (n == 0 || n > avail) return 0;
+            while (p[n - 1] & 0x01) {
+                if (n + it.ext > avail) return 0;
+                n += it.ext;
+            }
+            return n;
+        }
+
+        case UapItemType::Repetitive: {
+            if (avail < 1) return 0;
+            size_t n = 1 + size_t(p[0]) * it.len;
+            return n <= avail ? n : 0;
+        }
+
+        case UapItemType::Explicit: {
+            if (avail < 1 || p[0] == 0) return 0;
+            return p[0] <= avail ? p[0] : 0;
+        }
+
+        case UapItemType::Compound: {
+            // Primary subfield: 7 presence bits per octet, FX in the LSB
+            size_t ps = 0;
+            do {
+                if (ps >= avail) return 0;
+            } while (p[ps++] & 0x01);
+
+            size_t n = ps;
+            for (size_t byte = 0; byte < ps; ++byte) {
+                for (int bit = 0; bit < 7; ++bit) {
+                    if (!(p[byte] & (0x80 >> bit))) continue;
+                    size_t idx = byte * 7 + bit;
+                    if (idx >= it.subCount || it.sub[idx].type == UapItemType::Spare) return 0;
+                    size_t sl = itemLength(it.sub[idx], p + n, end);
+                    if (sl == 0) return 0;
+                    n += sl;
+                }
+            }
+            return n;
+        }
+
+        case UapItemType::Spare:
+        default:
+            return 0;
+    }
+}
+
+const uint8_t* AsterixDecoder::walkRecord(const UapTable& uap, const uint8_t* p, const uint8_t* end, RecordItems& items) {
+    // FSPEC
+    const uint8_t* fspec = p;
+    size_t fsLen = 0;
+    do {
+        if (p + fsLen >= end || fsLen * 7 >= ASTERIX_MAX_FRN) return nullptr;
+    } while (p[fsLen++] & 0x01);
+    p += fsLen;
+
+    items.present = 0;
+    for (size_t byte = 0; byte < fsLen; ++byte) {
+        uint8_t bits = fspec[byte] & 0xFE;
+        for (int bit = 0; bits && bit < 7; ++bit) {
+            if (!(fspec[byte] & (0x80 >> bit))) continue;
+            int frn = int(byte * 7 + bit) + 1;
+            if (frn > uap.count) return nullptr;
+
+            const UapItem& it = uap.items[frn - 1];
+            size_t len = itemLength(it, p, end);
+            if (len == 0) return nullptr;
+
+            items.items[frn - 1] = {p, uint16_t(len)};
+            items.present |= 1ULL << (frn - 1);
+            p += len;
+        }
+    }
+    return p;
+}
+
+// --- TYPED DECODING ---
+static void decodeCallsign(const uint8_t* p, char* out) {
+    // 8 characters, 6 bits each (ICAO IA-5 subset)
+    uint64_t v = 0;
+    for (int i = 0; i < 6; ++i) v = (v << 8) | p[i];
+    for (int i = 0; i < 8; ++i) {
+        uint8_t c = (v >> (42 - 6 * i)) & 0x3F;
+        if (c >= 1 && c <= 26) out[i] = char('A' + c - 1);
+        else if (c >= 48 && c <= 57) out[i] = char(c);
+        else out[i] = ' ';
+    }
+    out[8] = '\0';
+    for (int i = 7; i >= 0 && out[i] == ' '; --i) out[i] = '\0';
+}
+
+// --- SPECIALISED DECODERS ---
+// CAT048 and CAT034 run at full rate, so their UAP is baked in at compile time.
+// Every FSPEC octet value maps through a 256-entry table to the FRNs it selects
+// and the offsets of its leading fixed-length items: an octet whose items are
+// all fixed costs one bounds check, and each item is decoded straight into the
+// record with no intermediate RecordItems.
+struct FspecOctet {
+    bool valid = false;           // No spare or out-of-UAP FRN selected
+    uint8_t count = 0;            // Items selected by this octet
+    uint8_t frn[7] = {};          // Their FRNs, in wire order
+    uint8_t offset[7] = {};       // Offset from the octet's first item (leading fixed run only)
+    uint8_t fixedRun = 0;         // Leading items whose length is known at compile time
+    uint8_t fixedLen = 0;         // Their total length
+};
+
+template <size_t N>
+struct FspecLut {
+    FspecOctet octet[(N + 6) / 7][256];
+};
+
+template <size_t N>
+static constexpr FspecLut<N> buildFspecLut(const UapItem (&uap)[N]) {
+    FspecLut<N> lut{};
+    for (size_t o = 0; o < (N + 6) / 7; ++o) {
+        for (int v = 0; v < 256; ++v) {
+            FspecOctet& e = lut.octet[o][v];
+            e.valid = true;
+            bool run = true;
+            for (int bit = 0; bit < 7; ++bit) {
+                if (!(v & (0x80 >> bit))) continue;
+                size_t frn = o * 7 + bit + 1;
+                if (frn > N || uap[frn - 1].type == UapItemType::Spare) { e.valid = false; break; }
+                e.frn[e.count] = uint8_t(frn);
+                if (run && uap[frn - 1].type == UapItemType::Fixed) {
+                    e.offset[e.count] = e.fixedLen;
+                    e.fixedLen += uint8_t(uap[frn - 1].len);
+                    e.fixedRun++;
+                } else {
+                    run = false;
+                }
+                e.count++;
+            }
+        }
+    }
+    return lut;
+}
+
+template <uint8_t CAT> struct FastCategory;
+
+template <> struct FastCategory<48> {
+    using Record = Cat048Record;
+    static constexpr auto& UAP = CAT048_UAP;
+    static constexpr auto LUT = buildFspecLut(CAT048_UAP);
+    // Cat048Field decoded from each FRN (0: located only)
+    static constexpr uint32_t FIELD[28] = {
+        C048_DATA_SOURCE, C048_TIME, C048_REPORT_TYPE, C048_POLAR, C048_MODE3A, C048_FLIGHT_LEVEL, 0,
+        C048_ADDRESS, C048_CALLSIGN, C048_MODE_S, C048_TRACK_NUMBER, C048_CARTESIAN, C048_VELOCITY, C048_TRACK_STATUS,
+        C048_TRACK_QUALITY
+    };
+
+    static inline void item(int frn, const uint8_t* p, Record& r) {
+        switch (frn) {
+            case 1: r.sac = p[0]; r.sic = p[1]; r.present |= C048_DATA_SOURCE; break;
+            case 2: r.timeOfDay = u24(p) / 128.0; r.present |= C048_TIME; break;
+            case 3: r.reportType = p[0]; r.present |= C048_REPORT_TYPE; break;
+            case 4:
+                r.rho = u16(p) / 256.0;
+                r.theta = u16(p + 2) * (360.0 / 65536.0);
+                r.present |= C048_POLAR;
+                break;
+            case 5: r.mode3A = u16(p) & 0x0FFF; r.present |= C048_MODE3A; break;
+            case 6: {
+                int32_t fl = u16(p) & 0x3FFF;
+                if (fl & 0x2000) fl -= 0x4000;
+                r.flightLevel = fl / 4.0;
+                r.present |= C048_FLIGHT_LEVEL;
+                break;
+            }
+            case 8: r.aircraftAddress = u24(p); r.present |= C048_ADDRESS; break;
+            case 9: decodeCallsign(p, r.callsign); r.present |= C048_CALLSIGN; break;
+            case 10: r.modeS = p + 1; r.modeSCount = p[0]; r.present |= C048_MODE_S; break;
+            case 11: r.trackNumber = u16(p) & 0x0FFF; r.present |= C048_TRACK_NUMBER; break;
+            case 12:
+                r.x = s16(p) / 128.0;
+                r.y = s16(p + 2) / 128.0;
+                r.present |= C048_CARTESIAN;
+                break;
+            case 13:
+                r.groundSpeed = u16(p) / 16384.0;
+                r.heading = u16(p + 2) * (360.0 / 65536.0);
+                r.present |= C048_VELOCITY;
+                break;
+            case 14: r.trackStatus = p[0]; r.present |= C048_TRACK_STATUS; break;
+            case 15:
+                r.sigmaX = p[0] / 128.0;
+                r.sigmaY = p[1] / 128.0;
+                r.sigmaV = p[2] / 16384.0;
+                r.sigmaH = p[3] * (360.0 / 4096.0);
+                r.present |= C048_TRACK_QUALITY;
+                break;
+            default: break;
+        }
+    }
+};
+
+template <> struct FastCategory<34> {
+    using Record = Cat034Record;
+    static constexpr auto& UAP = CAT034_UAP;
+    static constexpr auto LUT = buildFspecLut(CAT034_UAP);
+    static constexpr uint32_t FIELD[14] = {
+        C034_DATA_SOURCE, C034_MESSAGE_TYPE, C034_TIME, C034_SECTOR, C034_ROTATION, 0, 0,
+        0, 0, 0, C034_POSITION
+    };
+
+    static inline void item(int frn, const uint8_t* p, Record& r) {
+        switch (frn) {
+            case 1: r.sac = p[0]; r.sic = p[1]; r.present |= C034_DATA_SOURCE; break;
+            case 2: r.messageType = p[0]; r.present |= C034_MESSAGE_TYPE; break;
+            case 3: r.timeOfDay = u24(p) / 128.0; r.present |= C034_TIME; break;
+            case 4: r.sectorAzimuth = p[0] * (360.0 / 256.0); r.present |= C034_SECTOR; break;
+            case 5: r.rotationPeriod = u16(p) / 128.0; r.present |= C034_ROTATION; break;
+            case 11:
+                r.height = s16(p);
+                r.lat = s24(p + 2) * (180.0 / 8388608.0);
+                r.lon = s24(p + 5) * (180.0 / 8388608.0);
+                r.present |= C034_POSITION;
+                break;
+            default: break;
+        }
+    }
+};
+
+template <> struct FastCategory<21> {
+    using Record = Cat021Record;
+    static constexpr auto& UAP = CAT021_UAP;
+    static constexpr auto LUT = buildFspecLut(CAT021_UAP);
+    static constexpr uint32_t FIELD[49] = {
+        C021_DATA_SOURCE, C021_DESCRIPTOR, C021_TRACK_NUMBER, 0, C021_TIME, C021_POSITION, C021_POSITION_HR,
+        0, 0, 0, C021_ADDRESS, C021_TIME, 0, 0,
+        0, C021_GEO_HEIGHT, C021_QUALITY, 0, C021_MODE3A, 0, C021_FLIGHT_LEVEL,
+        0, 0, C021_BARO_RATE, C021_GEO_RATE, C021_VELOCITY, 0, 0,
+        C021_IDENTIFICATION, C021_EMITTER
+    };
+
+    // I155/I157: RE bit, then a 15-bit two's complement rate in 6.25 ft/min
+    static double rate(const uint8_t* p) {
+        int32_t v = u16(p) & 0x7FFF;
+        if (v & 0x4000) v -= 0x8000;
+        return v * 6.25;
+    }
+
+    static inline void item(int frn, const uint8_t* p, Record& r) {
+        switch (frn) {
+            case 1: r.sac = p[0]; r.sic = p[1]; r.present |= C021_DATA_SOURCE; break;
+            case 2: r.descriptor = p[0]; r.present |= C021_DESCRIPTOR; break;
+            case 3: r.trackNumber = u16(p) & 0x0FFF; r.present |= C021_TRACK_NUMBER; break;
+            case 5: r.timeOfDay = u24(p) / 128.0; r.present |= C021_TIME; break;
+            case 6:
+                r.lat = s24(p) * (180.0 / 8388608.0);
+                r.lon = s24(p + 3) * (180.0 / 8388608.0);
+                r.present |= C021_POSITION;
+                break;
+            case 7:
+                r.lat = int32_t(u16(p) << 16 | u16(p + 2)) * (180.0 / 1073741824.0);
+                r.lon = int32_t(u16(p + 4) << 16 | u16(p + 6)) * (180.0 / 1073741824.0);
+                r.present |= C021_POSITION_HR;
+                break;
+            case 11: r.address = u24(p); r.present |= C021_ADDRESS; break;
+            case 12:
+                // Reception time only stands in when applicability time is absent
+                if (!(r.present & C021_TIME)) { r.timeOfDay = u24(p) / 128.0; r.present |= C021_TIME; }
+                break;
+            case 16: r.geoHeight = s16(p) * 6.25; r.present |= C021_GEO_HEIGHT; break;
+            case 17:
+                r.nucr = (p[0] >> 5) & 0x07;
+                r.nic = (p[0] >> 1) & 0x0F;
+                if (p[0] & 0x01) {
+                    r.sil = (p[1] >> 5) & 0x03;
+                    r.nacp = (p[1] >> 1) & 0x0F;
+                }
+                r.present |= C021_QUALITY;
+                break;
+            case 19: r.mode3A = u16(p) & 0x0FFF; r.present |= C021_MODE3A; break;
+            case 21: r.flightLevel = s16(p) / 4.0; r.present |= C021_FLIGHT_LEVEL; break;
+            case 24: r.baroRate = rate(p); r.present |= C021_BARO_RATE; break;
+            case 25: r.geoRate = rate(p); r.present |= C021_GEO_RATE; break;
+            case 26:
+                r.groundSpeed = (u16(p) & 0x7FFF) / 16384.0;
+                r.trackAngle = u16(p + 2) * (360.0 / 65536.0);
+                r.present |= C021_VELOCITY;
+                break;
+            case 29: decodeCallsign(p, r.callsign); r.present |= C021_IDENTIFICATION; break;
+            case 30: r.emitter = p[0]; r.present |= C021_EMITTER; break;
+            default: break;
+        }
+    }
+};
+
+// Calls fn(subfield index, data) for each present subfield of a compound item
+// that itemLength() has already validated
+template <typename Fn>
+static void forEachSubfield(const UapItem& it, const uint8_t* p, Fn&& fn) {
+    size_t ps = 0;
+    while (p[ps++] & 0x01) {}
+    const uint8_t* q = p + ps;
+    const uint8_t* end = q + 0xFFFF;
+    for (size_t byte = 0; byte < ps; ++byte) {
+        for (int bit = 0; bit < 7; ++bit) {
+            if (!(p[byte] & (0x80 >> bit))) continue;
+            size_t idx = byte * 7 + bit;
+            fn(idx, q);
+            q += AsterixDecoder::itemLength(it.sub[idx], q, end);
+        }
+    }
+}
+
+template <> struct FastCategory<62> {
+    using Record = Cat062Record;
+    static constexpr auto& UAP = CAT062_UAP;
+    static constexpr auto LUT = buildFspecLut(CAT062_UAP);
+    static constexpr uint32_t FIELD[35] = {
+        C062_DATA_SOURCE, 0, 0, C062_TIME, C062_POSITION, C062_CARTESIAN, C062_VELOCITY,
+        0, C062_MODE3A, C062_IDENTIFICATION, C062_DERIVED, C062_TRACK_NUMBER, C062_TRACK_STATUS, C062_UPDATE_AGES,
+        0, C062_DATA_AGES, C062_MEASURED_FL, C062_GEO_ALTITUDE, C062_BARO_ALTITUDE, C062_CLIMB_RATE
+    };
+
+    static void derived(size_t sub, const uint8_t* p, Record& r) {
+        switch (sub + 1) {
+            case 1: r.address = u24(p); break;
+            case 2: decodeCallsign(p, r.derivedId); break;
+            case 3: r.magHeading = u16(p) * (360.0 / 65536.0); break;
+            case 4:
+                r.airspeedIsMach = p[0] & 0x80;
+                r.airspeed = (u16(p) & 0x7FFF) * (r.airspeedIsMach ? 0.001 : 1.0 / 16384.0);
+                break;
+            case 5: r.trueAirspeed = u16(p); break;
+            case 6: {
+                int32_t alt = u16(p) & 0x1FFF;
+                if (alt & 0x1000) alt -= 0x2000;
+                r.selectedAltitude = alt * 25.0;
+                break;
+            }
+            case 13: r.baroRate = s16(p) * 6.25; break;
+            case 17: r.trackAngle = u16(p) * (360.0 / 65536.0); break;
+            case 18: r.groundSpeed = s16(p) / 16384.0; break;
+            default: return;
+        }
+        r.derived |= 1u << sub;
+    }
+
+    static inline void item(int frn, const uint8_t* p, Record& r) {
+        switch (frn) {
+            case 1: r.sac = p[0]; r.sic = p[1]; r.present |= C062_DATA_SOURCE; break;
+            case 4: r.timeOfDay = u24(p) / 128.0; r.present |= C062_TIME; break;
+            case 5:
+                r.lat = int32_t(u16(p) << 16 | u16(p + 2)) * (180.0 / 33554432.0);
+                r.lon = int32_t(u16(p + 4) << 16 | u16(p + 6)) * (180.0 / 33554432.0);
+                r.present |= C062_POSITION;
+                break;
+            case 6:
+                r.x = s24(p) * 0.5;
+                r.y = s24(p + 3) * 0.5;
+                r.present |= C062_CARTESIAN;
+                break;
+            case 7:
+                r.vx = s16(p) * 0.25;
+                r.vy = s16(p + 2) * 0.25;
+                r.present |= C062_VELOCITY;
+                break;
+            case 9: r.mode3A = u16(p) & 0x0FFF; r.present |= C062_MODE3A; break;
+            case 10: decodeCallsign(p + 1, r.callsign); r.present |= C062_IDENTIFICATION; break;
+            case 11:
+                forEachSubfield(UAP[10], p, [&r](size_t sub, const uint8_t* q) { derived(sub, q, r); });
+                r.present |= C062_DERIVED;
+                break;
+            case 12: r.trackNumber = uint16_t(u16(p)); r.present |= C062_TRACK_NUMBER; break;
+            case 13: r.trackStatus = p[0]; r.present |= C062_TRACK_STATUS; break;
+            case 14:
+                forEachSubfield(UAP[13], p, [&r](size_t sub, const uint8_t* q) {
+                    // ADS (subfield 5) is the only two-octet age
+                    r.updateAge[sub] = uint16_t(sub == 4 ? u16(q) : q[0]);
+                    r.updateAgeMask |= uint16_t(1u << sub);
+                });
+                r.present |= C062_UPDATE_AGES;
+                break;
+            case 16:
+                forEachSubfield(UAP[15], p, [&r](size_t sub, const uint8_t* q) {
+                    r.dataAge[sub] = q[0];
+                    r.dataAgeMask |= 1u << sub;
+                });
+                r.present |= C062_DATA_AGES;
+                break;
+            case 17: r.measuredFL = s16(p) / 4.0; r.present |= C062_MEASURED_FL; break;
+            case 18: r.geoAltitude = s16(p) * 6.25; r.present |= C062_GEO_ALTITUDE; break;
+            case 19: {
+                // QNH flag in the top bit, then a 15-bit two's complement FL in 1/4
+                int32_t fl = u16(p) & 0x7FFF;
+                if (fl & 0x4000) fl -= 0x8000;
+                r.baroAltitude = fl / 4.0;
+                r.present |= C062_BARO_ALTITUDE;
+                break;
+            }
+            case 20: r.climbRate = s16(p) * 6.25; r.present |= C062_CLIMB_RATE; break;
+            default: break;
+        }
+    }
+};
+
+template <> struct FastCategory<240> {
+    using Record = Cat240Record;
+    static constexpr auto& UAP = CAT240_UAP;
+    static constexpr auto LUT = buildFspecLut(CAT240_UAP);
+    static constexpr uint32_t FIELD[14] = {
+        C240_DATA_SOURCE, C240_MESSAGE_TYPE, C240_RECORD_HEADER, C240_SUMMARY, C240_HEADER, C240_HEADER,
+        C240_RESOLUTION, C240_CELL_COUNT, C240_CELLS, C240_CELLS, C240_CELLS, C240_TIME
+    };
+
+    static uint32_t u32(const uint8_t* p) { return u16(p) << 16 | u16(p + 2); }
+
+    static inline void item(int frn, const uint8_t* p, Record& r) {
+        switch (frn) {
+            case 1: r.sac = p[0]; r.sic = p[1]; r.present |= C240_DATA_SOURCE; break;
+            case 2: r.messageType = p[0]; r.present |= C240_MESSAGE_TYPE; break;
+            case 3: r.recordHeader = u32(p); r.present |= C240_RECORD_HEADER; break;
+            case 4: r.present |= C240_SUMMARY; break;
+            case 5:
+            case 6:
+                // I040 counts cell duration in ns, I041 in fs
+                r.startAz = u16(p) * (360.0 / 65536.0);
+                r.endAz = u16(p + 2) * (360.0 / 65536.0);
+                r.startRange = u32(p + 4);
+                r.cellDuration = u32(p + 8) * (frn == 5 ? 1e-9 : 1e-15);
+                r.present |= C240_HEADER;
+                break;
+            case 7:
+                r.compressed = p[0] & 0x80;
+                r.bitsPerCell = (p[1] >= 1 && p[1] <= 6) ? uint8_t(1u << (p[1] - 1)) : 0;
+                r.present |= C240_RESOLUTION;
+                break;
+            case 8: r.validOctets = uint16_t(u16(p)); r.cellCount = u24(p + 2); r.present |= C240_CELL_COUNT; break;
+            case 9:
+            case 10:
+            case 11:
+                r.cells = p + 1;
+                r.cellBytes = uint32_t(p[0]) * UAP[frn - 1].len;
+                r.present |= C240_CELLS;
+                break;
+            case 12: r.timeOfDay = u24(p) / 128.0; r.present |= C240_TIME; break;
+            default: break;
+        }
+    }
+};
+
+template <> struct FastCategory<20> {
+    using Record = Cat020Record;
+    static constexpr auto& UAP = CAT020_UAP;
+    static constexpr auto LUT = buildFspecLut(CAT020_UAP);
+    static constexpr uint32_t FIELD[28] = {
+        C020_DATA_SOURCE, C020_DESCRIPTOR, C020_TIME, C020_POSITION, C020_CARTESIAN, C020_TRACK_NUMBER, C020_TRACK_STATUS,
+        C020_MODE3A, C020_VELOCITY, C020_FLIGHT_LEVEL, 0, C020_ADDRESS, C020_IDENTIFICATION, 0,
+        C020_GEO_HEIGHT, 0, 0, 0, C020_ACCURACY, C020_CONTRIBUTORS, C020_MODE_S
+    };
+
+    static inline void item(int frn, const uint8_t* p, Record& r) {
+        switch (frn) {
+            case 1: r.sac = p[0]; r.sic = p[1]; r.present |= C020_DATA_SOURCE; break;
+            case 2: r.descriptor = p[0]; r.present |= C020_DESCRIPTOR; break;
+            case 3: r.timeOfDay = u24(p) / 128.0; r.present |= C020_TIME; break;
+            case 4:
+                r.lat = int32_t(u16(p) << 16 | u16(p + 2)) * (180.0 / 33554432.0);
+                r.lon = int32_t(u16(p + 4) << 16 | u16(p + 6)) * (180.0 / 33554432.0);
+                r.present |= C020_POSITION;
+                break;
+            case 5: r.x = s24(p) * 0.5; r.y = s24(p + 3) * 0.5; r.present |= C020_CARTESIAN; break;
+            case 6: r.trackNumber = uint16_t(u16(p) & 0x0FFF); r.present |= C020_TRACK_NUMBER; break;
+            case 7: r.trackStatus = p[0]; r.present |= C020_TRACK_STATUS; break;
+            case 8: r.mode3A = u16(p) & 0x0FFF; r.present |= C020_MODE3A; break;
+            case 9: r.vx = s16(p) * 0.25; r.vy = s16(p + 2) * 0.25; r.present |= C020_VELOCITY; break;
+            case 10: {
+                // V, G, then a 14-bit two's complement FL in 1/4
+                int32_t fl = u16(p) & 0x3FFF;
+                if (fl & 0x2000) fl -= 0x4000;
+                r.flightLevel = fl / 4.0;
+                r.present |= C020_FLIGHT_LEVEL;
+                break;
+            }
+            case 12: r.address = u24(p); r.present |= C020_ADDRESS; break;
+            case 13: decodeCallsign(p + 1, r.callsign); r.present |= C020_IDENTIFICATION; break;
+            case 15: r.geoHeight = s16(p) * 6.25; r.present |= C020_GEO_HEIGHT; break;
+            case 19:
+                forEachSubfield(UAP[18], p, [&r](size_t sub, const uint8_t* q) {
+                    if (sub != 1) return;
+                    r.sigmaX = u16(q) * 0.25;
+                    r.sigmaY = u16(q + 2) * 0.25;
+                    r.present |= C020_ACCURACY;
+                });
+                break;
+            case 20: {
+                int n = 0;
+                for (int i = 0; i < p[0]; ++i) n += __builtin_popcount(p[1 + i]);
+                r.contributors = uint8_t(n);
+                r.present |= C020_CONTRIBUTORS;
+                break;
+            }
+            case 21: r.modeS = p + 1; r.modeSCount = p[0]; r.present |= C020_MODE_S; break;
+            default: break;
+        }
+    }
+};
+
+template <> struct FastCategory<19> {
+    using Record = Cat019Record;
+    static constexpr auto& UAP = CAT019_UAP;
+    static constexpr auto LUT = buildFspecLut(CAT019_UAP);
+    static constexpr uint32_t FIELD[14] = {
+        C019_DATA_SOURCE, C019_MESSAGE_TYPE, C019_TIME, C019_SYSTEM_STATUS, C019_PROCESSOR, C019_SENSORS, 0,
+        C019_REFERENCE_POINT, C019_REFERENCE_HEIGHT, C019_UNDULATION
+    };
+
+    static inline void item(int frn, const uint8_t* p, Record& r) {
+        switch (frn) {
+            case 1: r.sac = p[0]; r.sic = p[1]; r.present |= C019_DATA_SOURCE; break;
+            case 2: r.messageType = p[0]; r.present |= C019_MESSAGE_TYPE; break;
+            case 3: r.timeOfDay = u24(p) / 128.0; r.present |= C019_TIME; break;
+            case 4: r.systemStatus = p[0]; r.present |= C019_SYSTEM_STATUS; break;
+            case 5: r.processorStatus = p[0]; r.present |= C019_PROCESSOR; break;
+            case 6: r.sensors = p + 1; r.sensorCount = p[0]; r.present |= C019_SENSORS; break;
+            case 8:
+                r.refLat = int32_t(u16(p) << 16 | u16(p + 2)) * (180.0 / 1073741824.0);
+                r.refLon = int32_t(u16(p + 4) << 16 | u16(p + 6)) * (180.0 / 1073741824.0);
+                r.present |= C019_REFERENCE_POINT;
+                break;
+            case 9: r.refHeight = s16(p) * 0.25; r.present |= C019_REFERENCE_HEIGHT; break;
+            case 10: r.undulation = int8_t(p[0]); r.present |= C019_UNDULATION; break;
+            default: break;
+        }
+    }
+};
+
+template <size_t N>
+static constexpr bool fieldsWithin(const uint32_t (&field)[N], size_t limit) {
+    for (size_t i = limit; i < N; ++i) {
+        if (field[i]) return false;
+    }
+    return true;
+}
+
+// Walk one record with the category's FSPEC lookup table, calling
+// take(frn, item) for every item present. Same contract as walkRecord():
+// pointer just past the record, or nullptr.
+template <uint8_t CAT, typename Take>
+static const uint8_t* walkFast(const uint8_t* p, const uint8_t* end, Take&& take) {
+    using Cat = FastCategory<CAT>;
+    constexpr size_t octets = sizeof(Cat::LUT.octet) / sizeof(Cat::LUT.octet[0]);
+
+    const uint8_t* fspec = p;
+    size_t fsLen = 0;
+    do {
+        if (p + fsLen >= end || fsLen * 7 >= ASTERIX_MAX_FRN) return nullptr;
+    } while (p[fsLen++] & 0x01);
+    p += fsLen;
+
+    for (size_t o = 0; o < fsLen; ++o) {
+        uint8_t bits = fspec[o] & 0xFE;
+        if (!bits) continue;
+        if (o >= octets) return nullptr;
+
+        const FspecOctet& e = Cat::LUT.octet[o][bits];
+        if (!e.valid || e.fixedLen > size_t(end - p)) return nullptr;
+        for (uint8_t i = 0; i < e.fixedRun; ++i) take(e.frn[i], p + e.offset[i]);
+        p += e.fixedLen;
+
+        // Variable-length items after the fixed run still need their length read
+        for (uint8_t i = e.fixedRun; i < e.count; ++i) {
+            size_t len = AsterixDecoder::itemLength(Cat::UAP[e.frn[i] - 1], p, end);
+            if (len == 0) return nullptr;
+            take(e.frn[i], p);
+            p += len;
+        }
+    }
+    return p;
+}
+
+// Items outside 'want' are only located; complete() parses them later.
+template <uint8_t CAT>
+static const uint8_t* decodeRecord(const uint8_t* p, const uint8_t* end, typename FastCategory<CAT>::Record& r,
+                                   uint32_t want) {
+    using Cat = FastCategory<CAT>;
+    static_assert(fieldsWithin(Cat::FIELD, LazyItems::MAX_FRN), "typed items must be in the first LazyItems::MAX_FRN FRNs");
+
+    const uint8_t* rec = p;
+    return walkFast<CAT>(p, end, [&](int frn, const uint8_t* item) {
+        uint32_t field = Cat::FIELD[frn - 1];
+        if (field & want) {
+            Cat::item(frn, item, r);
+        } else if (field) {
+            r.lazy.base = rec;
+            r.lazy.offset[frn - 1] = uint16_t(item - rec);
+            r.lazy.located |= uint32_t(1) << (frn - 1);
+            r.lazy.pending |= field;
+        }
+    });
+}
+
+// One CAT048 item into row i of the raw columns (items without a column are ignored)
+static void columnItem048(int frn, const uint8_t* p, PlotColumns& c, size_t i) {
+    switch (frn) {
+        case 1: c.sac[i] = p[0]; c.sic[i] = p[1]; c.present[i] |= C048_DATA_SOURCE; break;
+        case 2: c.rawTime[i] = int32_t(u24(p)); c.present[i] |= C048_TIME; break;
+        case 4:
+            c.rawRho[i] = int32_t(u16(p));
+            c.rawTheta[i] = int32_t(u16(p + 2));
+            c.present[i] |= C048_POLAR;
+            break;
+        case 5: c.mode3A[i] = u16(p) & 0x0FFF; c.present[i] |= C048_MODE3A; break;
+        case 6: {
+            int32_t fl = int32_t(u16(p) & 0x3FFF);
+            c.rawFlightLevel[i] = (fl & 0x2000) ? fl - 0x4000 : fl;
+            c.present[i] |= C048_FLIGHT_LEVEL;
+            break;
+        }
+        case 8: c.address[i] = u24(p); c.present[i] |= C048_ADDRESS; break;
+        case 9: decodeCallsign(p, c.callsign[i].data()); c.present[i] |= C048_CALLSIGN; break;
+        case 10: c.modeS[i] = p + 1; c.modeSCount[i] = p[0]; c.present[i] |= C048_MODE_S; break;
+        case 11: c.trackNumber[i] = uint16_t(u16(p) & 0x0FFF); c.present[i] |= C048_TRACK_NUMBER; break;
+        case 13:
+            c.rawSpeed[i] = int32_t(u16(p));
+            c.rawHeading[i] = int32_t(u16(p + 2));
+            c.present[i] |= C048_VELOCITY;
+            break;
+        default: break;
+    }
+}
+
+// CAT048 straight into raw columns, no scaling: the projected column items
+// are parsed, the other column items only located as decodeRecord() does
+static bool decodeColumns048(const uint8_t* rec, const uint8_t* end, PlotColumns& c, uint32_t want) {
+    while (rec < end) {
+        size_t i = c.append();
+        const uint8_t* base = rec;
+        rec = walkFast<48>(rec, end, [&](int frn, const uint8_t* p) {
+            uint32_t field = FastCategory<48>::FIELD[frn - 1] & PlotColumns::FIELDS;
+            if (field & want) {
+                columnItem048(frn, p, c, i);
+            } else if (field) {
+                LazyItems& lazy = c.lazy[i];
+                lazy.base = base;
+                lazy.offset[frn - 1] = uint16_t(p - base);
+                lazy.located |= uint32_t(1) << (frn - 1);
+                lazy.pending |= field;
+            }
+        });
+        if (!rec) { c.count--; return false; }
+    }
+    return true;
+}
+
+template <uint8_t CAT>
+static const uint8_t* decodeOne(const uint8_t* rec, const uint8_t* end,
+                                std::vector<typename FastCategory<CAT>::Record>& out, uint32_t want) {
+    out.emplace_back();
+    const uint8_t* next = decodeRecord<CAT>(rec, end, out.back(), want);
+    if (!next) out.pop_back();
+    return next;
+}
+
+template <uint8_t CAT>
+static bool decodeBlock(const uint8_t* rec, const uint8_t* end, std::vector<typename FastCategory<CAT>::Record>& out,
+                        uint32_t want) {
+    while (rec < end) {
+        rec = decodeOne<CAT>(rec, end, out, want);
+        if (!rec) return false;
+    }
+    return true;
+}
+
+template <uint8_t CAT>
+static void completeRecord(typename FastCategory<CAT>::Record& r, uint32_t fields) {
+    using Cat = FastCategory<CAT>;
+    uint32_t todo = r.lazy.pending & fields;
+    if (!todo) return;
+    // Every located item of the requested fields, in FRN order as decoding would
+    for (uint32_t located = r.lazy.located; located; located &= located - 1) {
+        int frn = __builtin_ctz(located) + 1;
+        if (!(Cat::FIELD[frn - 1] & todo)) continue;
+        Cat::item(frn, r.lazy.base + r.lazy.offset[frn - 1], r);
+        r.lazy.located &= ~(uint32_t(1) << (frn - 1));
+    }
+    r.lazy.pending &= ~fields;
+}
+
+// --- PROJECTIONS ---
+void AsterixDecoder::addProjection(const AsterixProjection& p) {
+    if (!m_projected) {
+        m_want048 = m_want034 = m_want021 = m_want062 = m_want240 = m_want020 = m_want019 = 0;
+        m_projected = true;
+    }
+    m_want048 |= p.cat048;
+    m_want034 |= p.cat034;
+    m_want021 |= p.cat021;
+    m_want062 |= p.cat062;
+    m_want240 |= p.cat240;
+    m_want020 |= p.cat020;
+    m_want019 |= p.cat019;
+}
+
+void AsterixDecoder::complete(Cat048Record& r, uint32_t fields) { completeRecord<48>(r, fields); }
+void AsterixDecoder::complete(Cat034Record& r, uint32_t fields) { completeRecord<34>(r, fields); }
+void AsterixDecoder::complete(Cat021Record& r, uint32_t fields) { completeRecord<21>(r, fields); }
+void AsterixDecoder::complete(Cat062Record& r, uint32_t fields) { completeRecord<62>(r, fields); }
+void AsterixDecoder::complete(Cat240Record& r, uint32_t fields) { completeRecord<240>(r, fields); }
+void AsterixDecoder::complete(Cat020Record& r, uint32_t fields) { completeRecord<20>(r, fields); }
+void AsterixDecoder::complete(Cat019Record& r, uint32_t fields) { completeRecord<19>(r, fields); }
+
+void AsterixDecoder::complete(PlotColumns& c, size_t row, uint32_t fields) {
+    LazyItems& lazy = c.lazy[row];
+    uint32_t todo = lazy.pending & fields;
+    if (!todo) return;
+    for (uint32_t located = lazy.located; located; located &= located - 1) {
+        int frn = __builtin_ctz(located) + 1;
+        if (!(FastCategory<48>::FIELD[frn - 1] & todo)) continue;
+        columnItem048(frn, lazy.base + lazy.offset[frn - 1], c, row);
+        lazy.located &= ~(uint32_t(1) << (frn - 1));
+    }
+    lazy.pending &= ~fields;
+    c.convert(row, row + 1);
+}
+
+// --- DATAGRAM ---
+bool AsterixDecoder::decode(const uint8_t* data, size_t len, AsterixDecodeResult& out) const {
+    const uint8_t* p = data;
+    const uint8_t* end = data + len;
+    size_t before = out.records();
+    size_t firstPlot = out.plots048.count;
+
+    // A datagram may carry several data blocks: CAT (1) | LEN (2) | records...
+    while (end - p >= 3) {
+        uint8_t cat = p[0];
+        size_t blockLen = u16(p + 1);
+        if (blockLen < 3 || blockLen > size_t(end - p)) { out.skippedBlocks++; break; }
+
+        const uint8_t* rec = p + 3;
+        const uint8_t* blockEnd = p + blockLen;
+        p = blockEnd;
+        out.blocks++;
+
+        bool ok;
+        bool builtin = (cat == 48 || cat == 34 || cat == 21 || cat == 62 || cat == 240 || cat == 20 || cat == 19);
+        if (builtin && m_spec && m_spec->hasSources(cat)) ok = decodeSourceBlock(cat, rec, blockEnd, out);
+        else if (cat == 48 && m_columns048) ok = decodeColumns048(rec, blockEnd, out.plots048, m_want048);
+        else if (cat == 48) ok = decodeBlock<48>(rec, blockEnd, out.cat048, m_want048);
+        else if (cat == 34) ok = decodeBlock<34>(rec, blockEnd, out.cat034, m_want034);
+        else if (cat == 21) ok = decodeBlock<21>(rec, blockEnd, out.cat021, m_want021);
+        else if (cat == 62) ok = decodeBlock<62>(rec, blockEnd, out.cat062, m_want062);
+        else if (cat == 240) ok = decodeBlock<240>(rec, blockEnd, out.cat240, m_want240);
+        else if (cat == 20) ok = decodeBlock<20>(rec, blockEnd, out.cat020, m_want020);
+        else if (cat == 19) ok = decodeBlock<19>(rec, blockEnd, out.cat019, m_want019);
+        else if (m_spec && m_spec->hasCategory(cat)) {
+            while (rec && rec < blockEnd) rec = m_spec->decodeRecord(cat, rec, blockEnd, out);
+            ok = rec != nullptr;
+        } else {
+            ok = false;
+        }
+        if (!ok) out.skippedBlocks++;
+    }
+    if (out.plots048.count > firstPlot) out.plots048.convert(firstPlot);
+    return out.records() > before;
+}
+
+// A built-in category block where some sources use another edition from the spec:
+// peek each record's I010 and pick the decoder per record
+bool AsterixDecoder::decodeSourceBlock(uint8_t cat, const uint8_t* rec, const uint8_t* end, AsterixDecodeResult& out) const {
+    while (rec < end) {
+        int edition = -1;
+        size_t fsLen = 0;
+        while (rec + fsLen < end && (rec[fsLen] & 0x01)) fsLen++;
+        fsLen++;
+        if ((rec[0] & 0x80) && rec + fsLen + 2 <= end) {
+            edition = m_spec->sourceEdition(cat, rec[fsLen], rec[fsLen + 1]);
+        }
+
+        const uint8_t* next;
+        if (edition >= 0) next = m_spec->decodeRecord(cat, rec, end, out, edition);
+        else if (cat == 48) next = decodeOne<48>(rec, end, out.cat048, m_want048);
+        else if (cat == 34) next = decodeOne<34>(rec, end, out.cat034, m_want034);
+        else if (cat == 21) next = decodeOne<21>(rec, end, out.cat021, m_want021);
+        else if (cat == 62) next = decodeOne<62>(rec, end, out.cat062, m_want062);
+        else if (cat == 240) next = decodeOne<240>(rec, end, out.cat240, m_want240);
+        else if (cat == 20) next = decodeOne<20>(rec, end, out.cat020, m_want020);
+        else next = decodeOne<19>(rec, end, out.cat019, m_want019);
+        if (!next) return false;
+        rec = next;
+    }
+    return true;
+}
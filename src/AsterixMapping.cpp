@@ -1,74 +1,81 @@
+#include "AsterixMapping.hpp"
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
-#include <string>
-#include <map>
+#include <unordered_set>
 #include <nlohmann/json.hpp>
 
-using json = nlohmann::json;
+using json = nlohmann::ordered_json;
 
-// Structure to hold our mapping pair
-struct AsterixMapping {
-    std::string source; // e.g., "asterix.048_010_SAC"
-    std::string target; // e.g., "Cat48_SAC"
-};
+std::string_view AsterixConfigParser::normalize(std::string_view source) {
+    if (source.compare(0, 8, "asterix.") == 0) source.remove_prefix(8);
+    while (source.size() > 8 && source.compare(0, 8, "asterix_") == 0) source.remove_prefix(8);
+    return source;
+}
 
-class AsterixConfigParser {
-private:
-    // Outer Map: Category Name (e.g., "CAT_48_MAP")
-    // Inner Map: Field Key (e.g., "SAC") -> Mapping Struct
-    std::map<std::string, std::map<std::string, AsterixMapping>> config_data;
+bool AsterixConfigParser::loadConfig(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Could not open file: " << filename << std::endl;
+        return false;
+    }
 
-public:
-    bool loadConfig(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            std::cerr << "Could not open file: " << filename << std::endl;
-            return false;
-        }
+    // Keep the file's field order; it becomes the column order in fields mode
+    json j = json::parse(file, nullptr, false);
+    if (j.is_discarded()) {
+        std::cerr << "Could not parse file: " << filename << std::endl;
+        return false;
+    }
 
-        json j;
-        file >> j;
+    m_fields.clear();
+    std::unordered_set<std::string> names;   // Normalised sources seen so far
+    for (auto& [cat_name, fields] : j.items()) {
+        for (auto& [field_key, mapping_values] : fields.items()) {
+            AsterixMapping mapping;
+            mapping.source = mapping_values["source"];
+            mapping.target = mapping_values["target"];
+            mapping.group = cat_name;
+            mapping.key = field_key;
+            std::string_view name = normalize(mapping.source);
+            int cat = std::atoi(std::string(name.substr(0, 3)).c_str());
+            if (cat > 0 && cat < 256) mapping.category = uint8_t(cat);
 
-        for (auto& [cat_name, fields] : j.items()) {
-            for (auto& [field_key, mapping_values] : fields.items()) {
-                AsterixMapping mapping;
-                mapping.source = mapping_values["source"];
-                mapping.target = mapping_values["target"];
-                
-                config_data[cat_name][field_key] = mapping;
+            // "asterix.048_040_RHO" and "048_040_RHO" are the same field
+            if (!names.emplace(name).second) {
+                std::cerr << "Duplicate mapping source ignored: " << mapping.source << std::endl;
+                continue;
             }
+            mapping.id = int(m_fields.size());
+            m_fields.push_back(std::move(mapping));
         }
-        return true;
     }
 
-    AsterixMapping getMapping(const std::string& category, const std::string& field) {
-        if (config_data.count(category) && config_data[category].count(field)) {
-            return config_data[category][field];
-        }
-        return {"NOT_FOUND", "NOT_FOUND"};
+    std::vector<std::string_view> keys;
+    keys.reserve(m_fields.size());
+    for (const auto& m : m_fields) keys.push_back(normalize(m.source));
+    if (!m_index.build(keys)) {
+        std::cerr << "Could not index mapping sources: " << filename << std::endl;
+        m_fields.clear();
+        m_index.build({});
+        return false;
     }
+    return true;
+}
 
-    void printAll() {
-        for (auto const& [cat, fields] : config_data) {
-            std::cout << "--- " << cat << " ---" << std::endl;
-            for (auto const& [key, map] : fields) {
-                std::cout << key << " -> " << map.source << " | " << map.target << std::endl;
-            }
-        }
+const AsterixMapping* AsterixConfigParser::getMapping(const std::string& category, const std::string& field) const {
+    for (const auto& m : m_fields) {
+        if (m.group == category && m.key == field) return &m;
     }
-};
+    return nullptr;
+}
 
-// int main() {
-//     AsterixConfigParser parser;
-
-//     if (parser.loadConfig("mapping.json")) {
-//         // Example 1: Look up a specific field
-//         AsterixMapping m = parser.getMapping("CAT_48_MAP", "TrackNumber");
-//         std::cout << "Target Name for TrackNumber: " << m.target << std::endl;
-
-//         // Example 2: Print everything loaded
-//         // parser.printAll();
-//     }
-
-//     return 0;
-// }
\ No newline at end of file
+void AsterixConfigParser::printAll() const {
+    const std::string* group = nullptr;
+    for (const auto& m : m_fields) {
+        if (!group || *group != m.group) {
+            group = &m.group;
+            std::cout << "--- " << m.group << " ---" << std::endl;
+        }
+        std::cout << m.key << " -> " << m.source << " | " << m.target << std::endl;
+    }
+}
@@ -0,0 +1,202 @@
+#include "BpfFilter.hpp"
+#include "Logger.hpp"
+#include <sys/socket.h>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+
+namespace {
+// Tiny assembler: jumps name labels, resolved to relative offsets by finish().
+// ACCEPT and DROP are appended last; NEXT falls through.
+class Asm {
+public:
+    static constexpr int NEXT = -1, ACCEPT = -2, DROP = -3;
+
+    int label() { m_labels.push_back(-1); return int(m_labels.size() - 1); }
+    void bind(int l) { m_labels[l] = int(m_code.size()); }
+
+    void stmt(uint16_t code, uint32_t k) {
+        m_code.push_back(BPF_STMT(code, k));
+        m_targets.push_back({NEXT, NEXT});
+    }
+    void jump(uint16_t code, uint32_t k, int jt, int jf) {
+        m_code.push_back(BPF_JUMP(code, k, 0, 0));
+        m_targets.push_back({jt, jf});
+    }
+    void ja(int target) {
+        m_code.push_back(BPF_JUMP(BPF_JMP | BPF_JA, 0, 0, 0));
+        m_targets.push_back({target, NEXT});
+    }
+
+    std::vector<sock_filter> finish() {
+        int accept = int(m_code.size()), drop = accept + 1;
+        m_code.push_back(BPF_STMT(BPF_RET | BPF_K, 0x40000));  // ACCEPT (whole packet)
+        m_code.push_back(BPF_STMT(BPF_RET | BPF_K, 0));        // DROP
+        auto resolve = [&](int t, int at) {
+            int abs = (t == NEXT) ? at + 1 : (t == ACCEPT) ? accept : (t == DROP) ? drop : m_labels[t];
+            return abs - at - 1;
+        };
+        for (size_t i = 0; i < m_targets.size(); ++i) {
+            sock_filter& f = m_code[i];
+            if (BPF_CLASS(f.code) != BPF_JMP) continue;
+            if (BPF_OP(f.code) == BPF_JA) { f.k = uint32_t(resolve(m_targets[i].first, int(i))); continue; }
+            int jt = resolve(m_targets[i].first, int(i)), jf = resolve(m_targets[i].second, int(i));
+            if (jt > 255 || jf > 255) {
+                Logger::error("[BPF] Filter too large ({} instructions)", m_code.size());
+                return {};
+            }
+            f.jt = uint8_t(jt);
+            f.jf = uint8_t(jf);
+        }
+        return m_code;
+    }
+
+private:
+    std::vector<sock_filter> m_code;
+    std::vector<std::pair<int, int>> m_targets;
+    std::vector<int> m_labels;
+};
+
+// Service messages that lead a radar's datagram ahead of its plots
+constexpr int LEADING_CATEGORIES[] = {2, 34};
+
+// ASTERIX checks on the payload at X + 'base'. Falls through on a match.
+void emitAsterix(Asm& a, uint32_t base, const AsterixSelect& select) {
+    if (!select.categories.empty()) {
+        int ok = a.label();
+        std::vector<int> cats = select.categories;
+        for (int c : LEADING_CATEGORIES) {
+            if (std::find(cats.begin(), cats.end(), c) == cats.end()) cats.push_back(c);
+        }
+        a.stmt(BPF_LD | BPF_B | BPF_IND, base);                     // CAT
+        for (size_t i = 0; i < cats.size(); ++i) {
+            bool last = (i + 1 == cats.size());
+            a.jump(BPF_JMP | BPF_JEQ | BPF_K, uint32_t(cats[i]), ok, last ? Asm::DROP : Asm::NEXT);
+        }
+        a.bind(ok);
+    }
+
+    if (!select.sources.empty()) {
+        // I010 is FRN 1: present when the first FSPEC octet has 0x80, and it
+        // follows the FSPEC, whose length is only known by walking FX bits
+        // (unrolled; 7 octets covers every UAP we handle)
+        const int MAX_FSPEC = 7;
+        int check = a.label();
+        a.stmt(BPF_LD | BPF_B | BPF_IND, base + 3);
+        a.jump(BPF_JMP | BPF_JSET | BPF_K, 0x80, Asm::NEXT, Asm::DROP);
+        for (int n = 1; n <= MAX_FSPEC; ++n) {
+            int more = a.label();
+            if (n > 1) a.stmt(BPF_LD | BPF_B | BPF_IND, base + 2 + n);
+            if (n < MAX_FSPEC) a.jump(BPF_JMP | BPF_JSET | BPF_K, 0x01, more, Asm::NEXT);
+            a.stmt(BPF_LD | BPF_H | BPF_IND, base + 3 + n);          // SAC/SIC
+            a.ja(check);
+            a.bind(more);
+        }
+
+        a.bind(check);
+        for (size_t i = 0; i < select.sources.size(); ++i) {
+            bool last = (i + 1 == select.sources.size());
+            a.jump(BPF_JMP | BPF_JEQ | BPF_K, uint32_t(select.sources[i]), Asm::ACCEPT, last ? Asm::DROP : Asm::NEXT);
+        }
+    }
+}
+}
+
+std::vector<sock_filter> BpfFilter::udpPort(int port, int linkHeaderLen) {
+    return udpPorts(std::vector<int>{port}, linkHeaderLen);
+}
+
+static bool tooManySources(const AsterixSelect& select) {
+    if (select.sources.size() <= BpfFilter::MAX_SOURCES) return false;
+    Logger::error("[BPF] {} allowed sources, at most {} fit in a filter", select.sources.size(), BpfFilter::MAX_SOURCES);
+    return true;
+}
+
+std::vector<sock_filter> BpfFilter::udpPorts(const std::vector<int>& ports, int linkHeaderLen, const AsterixSelect& select) {
+    if (tooManySources(select)) return {};
+    const uint32_t L = linkHeaderLen;
+    Asm a;
+    int portOk = a.label();
+
+    // skb->protocol works for both Ethernet and cooked sockets
+    a.stmt(BPF_LD | BPF_H | BPF_ABS, SKF_AD_OFF + SKF_AD_PROTOCOL);
+    a.jump(BPF_JMP | BPF_JEQ | BPF_K, 0x0800, Asm::NEXT, Asm::DROP);       // IPv4?
+    a.stmt(BPF_LD | BPF_B | BPF_ABS, L + 9);
+    a.jump(BPF_JMP | BPF_JEQ | BPF_K, 17, Asm::NEXT, Asm::DROP);           // UDP?
+    a.stmt(BPF_LD | BPF_H | BPF_ABS, L + 6);
+    a.jump(BPF_JMP | BPF_JSET | BPF_K, 0x1FFF, Asm::DROP, Asm::NEXT);      // Not the first fragment
+    a.stmt(BPF_LDX | BPF_B | BPF_MSH, L);                                  // X = IP header length
+    a.stmt(BPF_LD | BPF_H | BPF_IND, L);                                   // UDP source port
+    for (int port : ports) a.jump(BPF_JMP | BPF_JEQ | BPF_K, uint32_t(port), portOk, Asm::NEXT);
+    a.stmt(BPF_LD | BPF_H | BPF_IND, L + 2);                               // UDP destination port
+    for (size_t i = 0; i < ports.size(); ++i) {
+        bool last = (i + 1 == ports.size());
+        a.jump(BPF_JMP | BPF_JEQ | BPF_K, uint32_t(ports[i]), portOk, last ? Asm::DROP : Asm::NEXT);
+    }
+    a.bind(portOk);
+
+    emitAsterix(a, L + 8, select);                                         // Payload after the UDP header
+    a.ja(Asm::ACCEPT);
+    return a.finish();
+}
+
+std::vector<sock_filter> BpfFilter::asterixPayload(const AsterixSelect& select) {
+    if (tooManySources(select)) return {};
+    Asm a;
+    a.stmt(BPF_LDX | BPF_IMM, 0);
+    emitAsterix(a, 8, select);
+    a.ja(Asm::ACCEPT);
+    return a.finish();
+}
+
+bool AsterixSelect::matches(const uint8_t* block, size_t len) const {
+    if (len < 3) return false;
+    if (!categories.empty() && std::find(categories.begin(), categories.end(), int(block[0])) == categories.end()) {
+        return false;
+    }
+    if (sources.empty()) return true;
+
+    // Same walk as the kernel program: I010 right after the FSPEC
+    if (len < 4 || !(block[3] & 0x80)) return false;
+    size_t i = 3;
+    while (i < len && (block[i] & 0x01)) ++i;
+    if (i + 2 >= len) return false;
+    int source = int(block[i + 1]) << 8 | block[i + 2];
+    return std::find(sources.begin(), sources.end(), source) != sources.end();
+}
+
+bool AsterixSelect::keepBlocks(const uint8_t* data, size_t len, std::vector<uint8_t>& out) const {
+    bool copying = false;
+    size_t off = 0;
+    while (off + 3 <= len) {
+        size_t blockLen = size_t(data[off + 1]) << 8 | data[off + 2];
+        if (blockLen < 3 || off + blockLen > len) break;
+        bool keep = matches(data + off, blockLen);
+        if (!keep && !copying) {
+            out.assign(data, data + off);   // Everything before the first dropped block
+            copying = true;
+        } else if (keep && copying) {
+            out.insert(out.end(), data + off, data + off + blockLen);
+        }
+        off += blockLen;
+    }
+    if (copying) out.insert(out.end(), data + off, data + len);
+    return copying;
+}
+
+bool BpfFilter::attach(int fd, const std::vector<sock_filter>& program) {
+    if (program.empty()) return false;
+    struct sock_fprog prog;
+    prog.len = static_cast<unsigned short>(program.size());
+    prog.filter = const_cast<sock_filter*>(program.data());
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0) {
+        Logger::error("[BPF] Failed to attach filter: {}", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool BpfFilter::detach(int fd) {
+    int dummy = 0;
+    return setsockopt(fd, SOL_SOCKET, SO_DETACH_FILTER, &dummy, sizeof(dummy)) == 0 || errno == ENOENT;
+}
@@ -23,7 +23,7 @@ bool ConfigLoader::load(const std::string& path, AppConfig& config) {
         if (j.contains("system")) {
             config.isMSCTactive = j["system"].value("isMSCTActive", false);
             config.site_name = j["system"].value("site", "");
-            config.tick_rate_ms = j["system"].value("tick_rate_ms", 10);
+            config.tick_rate_ms = j["system"].value("tick_rate_ms", 1000);
             config.pid_file = j["system"].value("pid_file", "/tmp/targex.pid");
             config.rx_port_web = j["system"].value("webport", 8080);
         }
@@ -36,10 +36,25 @@ bool ConfigLoader::load(const std::string& path, AppConfig& config) {
             config.interface = j["network_input"].value("interface", "ens34");
             config.rx_port = j["network_input"].value("port", 8600);
             config.multicast_group = j["network_input"].value("multicast_group", "0.0.0.0");
+            config.decoder_mode = j["network_input"].value("decoder", "native");
+            config.recv_batch_size = j["network_input"].value("batch_size", 64);
+            config.recv_buffer_count = j["network_input"].value("buffer_count", 2048);
+            config.recv_buffer_size = j["network_input"].value("buffer_size", 8192);
+            config.recv_socket_buffer = j["network_input"].value("socket_buffer", 4 * 1024 * 1024);
+            config.capture_mode = j["network_input"].value("capture", "ring");
+            config.ring_block_size = j["network_input"].value("ring_block_size", 1 << 20);
+            config.ring_block_count = j["network_input"].value("ring_block_count", 64);
+            config.promiscuous = j["network_input"].value("promiscuous", true);
+            config.tshark_workers = j["network_input"].value("tshark_workers", 1);
+            config.tshark_dispatch = j["network_input"].value("tshark_dispatch", "roundrobin");
+            parseInputs(j["network_input"], config);
         }
 
-        if (j.contains("processing")) {
-            config.active_categories = j["processing"].value("active_categories", std::vector<int>{});
+        if (j.contains("processing") && !parseProcessing(j["processing"], config)) {
+            return false;
+        }
+        if (j.contains("video")) {
+            parseVideo(j["video"], config);
         }
         if (j.contains("output")) {
             config.isEnabled = j["output"].value("enabled", true);
@@ -53,4 +68,82 @@ bool ConfigLoader::load(const std::string& path, AppConfig& config) {
         Logger::error("[CONFIG] JSON Parse Error: ", e.what());
         return false;
     }
-}
\ No newline at end of file
+}
+
+void ConfigLoader::parseInputs(const json& networkInput, AppConfig& config) {
+    config.inputs.clear();
+
+    if (networkInput.contains("inputs") && networkInput["inputs"].is_array()) {
+        for (const auto& in : networkInput["inputs"]) {
+            InputConfig input;
+            input.interface = in.value("interface", config.interface);
+            input.port = in.value("port", config.rx_port);
+            input.group = in.value("multicast_group", in.value("group", std::string()));
+            input.label = in.value("label", "input" + std::to_string(config.inputs.size()));
+            if (input.group == "0.0.0.0") input.group.clear();
+            config.inputs.push_back(input);
+        }
+    }
+
+    if (config.inputs.empty()) {
+        InputConfig input;
+        input.interface = config.interface;
+        input.port = config.rx_port;
+        input.group = (config.multicast_group == "0.0.0.0") ? "" : config.multicast_group;
+        input.label = "primary";
+        config.inputs.push_back(input);
+    } else {
+        // The first input drives the single-source paths (capture ring, dumpcap)
+        config.interface = config.inputs[0].interface;
+        config.rx_port = config.inputs[0].port;
+        config.multicast_group = config.inputs[0].group;
+    }
+}
+
+bool ConfigLoader::parseSelect(const json& processing, AsterixSelect& select) {
+    AsterixSelect parsed;
+    parsed.categories = processing.value("active_categories", std::vector<int>{});
+
+    if (processing.contains("allowed_sources") && processing["allowed_sources"].is_array()) {
+        for (const auto& src : processing["allowed_sources"]) {
+            if (!src.is_object()) continue;
+            int sac = src.value("sac", -1), sic = src.value("sic", -1);
+            if (sac < 0 || sac > 255 || sic < 0 || sic > 255) {
+                Logger::warn("[CONFIG] Ignoring invalid allowed_sources entry: {}", src.dump());
+                continue;
+            }
+            parsed.sources.push_back(sac << 8 | sic);
+        }
+    }
+    if (parsed.sources.size() > BpfFilter::MAX_SOURCES) {
+        Logger::error("[CONFIG] allowed_sources has {} entries, the filter holds at most {}; rejected",
+                      parsed.sources.size(), BpfFilter::MAX_SOURCES);
+        return false;
+    }
+    select = std::move(parsed);
+    return true;
+}
+
+bool ConfigLoader::parseProcessing(const json& processing, AppConfig& config) {
+    AsterixSelect select;
+    if (!parseSelect(processing, select)) return false;
+    config.active_categories = std::move(select.categories);
+    config.allowed_sources = std::move(select.sources);
+    return true;
+}
+
+json ConfigLoader::sourcesToJson(const std::vector<int>& sources) {
+    json out = json::array();
+    for (int s : sources) out.push_back({{"sac", s >> 8}, {"sic", s & 0xFF}});
+    return out;
+}
+
+void ConfigLoader::parseVideo(const json& video, AppConfig& config) {
+    config.video_enabled = video.value("enabled", false);
+    config.video_range_nm = video.value("range_nm", 32.0);
+    config.video_raster_size = video.value("raster_size", 1024);
+    if (config.video_raster_size < 64 || config.video_raster_size > 4096) {
+        Logger::warn("[CONFIG] video.raster_size {} out of range, using 1024", config.video_raster_size);
+        config.video_raster_size = 1024;
+    }
+}
@@ -0,0 +1,128 @@
+#include "EkExtractor.hpp"
+#include "AsterixMapping.hpp"
+#include <charconv>
+#include <cstring>
+
+static constexpr std::string_view LAYER_PREFIX = "asterix_";
+
+bool EkExtractor::compile(const AsterixConfigParser* mapping) {
+    struct Core { EkFieldId id; const char* name; const char* alias; };
+    static const Core core[] = {
+        {EK_LAT,          "034_120_LAT",   nullptr},
+        {EK_LON,          "034_120_LON",   nullptr},
+        {EK_RHO,          "048_040_RHO",   nullptr},
+        {EK_THETA,        "048_040_THETA", nullptr},
+        {EK_TRACK_NUMBER, "048_161_TN",    "048_161_TRN"},
+        {EK_CATEGORY,     "category",      nullptr},
+        {EK_SAC,          "048_010_SAC",   "034_010_SAC"},
+        {EK_SIC,          "048_010_SIC",   "034_010_SIC"},
+    };
+
+    // Ids 0..n-1 are the mapping's; keys are views into the mapping or the
+    // literals above, needed only while the index is built
+    std::vector<std::string_view> keys;
+    if (mapping) {
+        for (const auto& m : mapping->allMappings()) keys.push_back(AsterixConfigParser::normalize(m.source));
+    }
+    m_slot.assign(keys.size(), -1);
+
+    auto bind = [&](std::string_view name, EkFieldId slot) {
+        int id = mapping ? mapping->fieldId(name) : -1;
+        if (id < 0) {
+            id = int(keys.size());
+            keys.push_back(name);
+            m_slot.push_back(-1);
+        }
+        m_slot[id] = int8_t(slot);
+    };
+    for (const auto& c : core) {
+        bind(c.name, c.id);
+        if (c.alias) bind(c.alias, c.id);
+    }
+
+    if (!m_index.build(keys)) {
+        m_index.build({});
+        m_slot.clear();
+        return false;
+    }
+    return true;
+}
+
+// --- SCANNER ---
+static const char* skipWs(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) ++p;
+    return p;
+}
+
+// p is just past an opening quote; returns the closing quote (or end)
+static const char* endOfString(const char* p, const char* end) {
+    while (p < end) {
+        const char* q = static_cast<const char*>(memchr(p, '"', size_t(end - p)));
+        if (!q) return end;
+        // Quote is escaped if preceded by an odd number of backslashes
+        const char* b = q;
+        while (b > p && b[-1] == '\\') --b;
+        if (((q - b) & 1) == 0) return q;
+        p = q + 1;
+    }
+    return end;
+}
+
+// Numeric value at p: 1.5, "1.5", [1.5, ...] or ["1.5", ...]
+bool EkExtractor::parseNumber(const char* p, const char* end, double& out) {
+    p = skipWs(p, end);
+    if (p < end && *p == '[') p = skipWs(p + 1, end);
+    if (p < end && *p == '"') ++p;
+    if (p < end && *p == '+') ++p;
+    if (p >= end) return false;
+
+    // tshark renders a few integer fields in hex ("0x00000012")
+    if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        unsigned long long v = 0;
+        auto [hp, hec] = std::from_chars(p + 2, end, v, 16);
+        if (hec != std::errc()) return false;
+        out = double(v);
+        return true;
+    }
+
+    auto [ptr, ec] = std::from_chars(p, end, out);
+    return ec == std::errc();
+}
+
+bool EkExtractor::extract(const char* line, size_t len, EkFields& out) const {
+    out.clear();
+    const char* p = line;
+    const char* end = line + len;
+    p = skipWs(p, end);
+    if (p >= end || *p != '{') return false;
+
+    // Every string followed by ':' is a key; values of other keys
+    // (including nested layers) are simply walked over as more tokens
+    while (p < end) {
+        const char* q = static_cast<const char*>(memchr(p, '"', size_t(end - p)));
+        if (!q) break;
+        const char* keyBegin = q + 1;
+        const char* keyEnd = endOfString(keyBegin, end);
+        if (keyEnd >= end) break;
+
+        p = skipWs(keyEnd + 1, end);
+        if (p >= end || *p != ':') continue;   // A string value, not a key
+        ++p;
+
+        std::string_view key(keyBegin, size_t(keyEnd - keyBegin));
+        if (key == "asterix") { out.hasAsterix = true; continue; }
+        if (key.size() <= LAYER_PREFIX.size() || key.compare(0, LAYER_PREFIX.size(), LAYER_PREFIX) != 0) continue;
+
+        int id = m_index.find(AsterixConfigParser::normalize(key));
+        if (id < 0) continue;
+        int slot = m_slot[id];
+        if (slot < 0 || out.has(slot)) continue;
+
+        double v;
+        if (parseNumber(p, end, v)) {
+            out.values[slot] = v;
+            out.present |= (uint32_t(1) << slot);
+        }
+    }
+    return true;
+}
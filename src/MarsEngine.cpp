@@ -1,7 +1,13 @@
 #include "MarsEngine.hpp"
 #include "Logger.hpp"
+#include "UdpReceiver.hpp"
+#include "PacketRing.hpp"
+#include "AsterixMapping.hpp"
+#include "TsharkPool.hpp"
+#include "UapSpec.hpp"
 #include <iostream>
 #include <cstdio>
+#include <iterator>
 #include <sstream>
 #include <cmath>
 #include <sys/socket.h>
@@ -11,7 +17,11 @@
 #include <iomanip>
 #include <unistd.h> 
 #include <fcntl.h> 
+#include <sys/eventfd.h>
 #include <fstream> 
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
 
 // OpenSSL Headers
 #include <openssl/ssl.h>
@@ -26,16 +36,40 @@ constexpr double EARTH_RADIUS_M = 6371000.0;
 constexpr double PI = 3.14159265358979323846;
 constexpr double NM_TO_M = 1852.0;
 
+// --- SCHEDULE (ms) ---
+constexpr uint64_t TRACK_TIMEOUT_MS = 20000;     // Track dropped after this long without a report
+constexpr uint64_t SENSOR_COT_MS = 10000;
+constexpr uint64_t HEARTBEAT_MS = 30000;         // TAK ping on stream connections
+constexpr uint64_t RECONNECT_MIN_MS = 5000;      // Doubles per failed attempt up to the max
+constexpr uint64_t RECONNECT_MAX_MS = 60000;
+constexpr uint64_t HOUSEKEEPING_MS = 10000;
+constexpr uint64_t FUSION_GRID_MS = 1000;        // Fused track grid rebuild
+constexpr double MODE_S_MAX_AGE_S = 30.0;        // Comm-B values not confirmed for this long are not shown
+
 // --- HELPERS ---
 double toRad(double deg) { return deg * PI / 180.0; }
 double toDeg(double rad) { return rad * 180.0 / PI; }
 
+static uint64_t steadyMs() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
 std::string getIsoTime(int secondsOffset) {
+    // A data block emits many events within the same second: reuse the
+    // formatted strings (decode thread only, a few distinct offsets)
+    struct Cached { std::time_t t = -1; std::string s; };
+    thread_local Cached cache[4];
     std::time_t now = std::time(nullptr) + secondsOffset;
-    std::tm* t = std::gmtime(&now);
-    std::stringstream ss;
-    ss << std::put_time(t, "%Y-%m-%dT%H:%M:%SZ");
-    return ss.str();
+    Cached& c = cache[now & 3];
+    if (c.t != now) {
+        std::tm* t = std::gmtime(&now);
+        std::stringstream ss;
+        ss << std::put_time(t, "%Y-%m-%dT%H:%M:%SZ");
+        c.s = ss.str();
+        c.t = now;
+    }
+    return c.s;
 }
 
 void polarToGeo(double sensorLat, double sensorLon, double rangeNm, double azDeg, double& outLat, double& outLon) {
@@ -50,8 +84,24 @@ void polarToGeo(double sensorLat, double sensorLon, double rangeNm, double azDeg
     outLon = toDeg(lon2);
 }
 
+// polarToGeo() over columns: the sensor terms are computed once per batch
+static void polarToGeoColumns(double sensorLat, double sensorLon, const double* rangeNm, const double* azDeg, size_t n,
+                              double* outLat, double* outLon) {
+    double lat1 = toRad(sensorLat);
+    double lon1 = toRad(sensorLon);
+    double sinLat1 = sin(lat1), cosLat1 = cos(lat1);
+    for (size_t i = 0; i < n; ++i) {
+        double angDist = rangeNm[i] * (NM_TO_M / EARTH_RADIUS_M);
+        double brng = toRad(azDeg[i]);
+        double sinD = sin(angDist), cosD = cos(angDist);
+        double sinLat2 = sinLat1 * cosD + cosLat1 * sinD * cos(brng);
+        outLat[i] = toDeg(asin(sinLat2));
+        outLon[i] = toDeg(lon1 + atan2(sin(brng) * sinD * cosLat1, cosD - sinLat1 * sinLat2));
+    }
+}
+
 // --- CONSTRUCTOR/DESTRUCTOR ---
-MarsEngine::MarsEngine(AppConfig& config) : m_config(config) {
+MarsEngine::MarsEngine(AppConfig& config, PacketPool& pool) : m_config(config), m_pool(pool) {
     SSL_library_init();
     OpenSSL_add_all_algorithms();
     SSL_load_error_strings();
@@ -59,6 +109,46 @@ MarsEngine::MarsEngine(AppConfig& config) : m_config(config) {
     // [FIX] LOAD LEGACY PROVIDER FOR OLD P12 FILES
     OSSL_PROVIDER_load(NULL, "legacy");
     OSSL_PROVIDER_load(NULL, "default");
+
+    for (size_t i = 0; i < m_config.inputs.size(); ++i) m_inputCounters.emplace_back();
+
+    // Further categories and per-source editions for the native decoder
+    auto spec = std::make_shared<UapSpec>();
+    if (spec->load("resources/asterix_spec.json")) {
+        AsterixConfigParser mapping;
+        if (mapping.loadConfig("resources/tshark_config.json")) spec->bindMapping(mapping);
+        m_decoder.setSpec(spec);
+    }
+
+    // Field projections: the decode thread parses only what its consumers read
+    m_decoder.addProjection({"cot", C048_TRACK_NUMBER | C048_POLAR | C048_CALLSIGN, C034_POSITION,
+                             C021_ADDRESS | C021_POSITION | C021_POSITION_HR | C021_IDENTIFICATION | C021_VELOCITY,
+                             C062_TRACK_NUMBER | C062_POSITION | C062_VELOCITY | C062_IDENTIFICATION, 0,
+                             C020_POSITION | C020_TRACK_NUMBER | C020_VELOCITY | C020_ADDRESS | C020_IDENTIFICATION,
+                             C019_DATA_SOURCE | C019_SYSTEM_STATUS | C019_PROCESSOR | C019_SENSORS |
+                             C019_REFERENCE_POINT | C019_REFERENCE_HEIGHT});
+    m_decoder.addProjection({"web", C048_DATA_SOURCE | C048_TIME | C048_FLIGHT_LEVEL | C048_VELOCITY,
+                             C034_DATA_SOURCE | C034_TIME,
+                             C021_DATA_SOURCE | C021_TIME | C021_FLIGHT_LEVEL,
+                             C062_DATA_SOURCE | C062_TIME | C062_MEASURED_FL, 0,
+                             C020_DATA_SOURCE | C020_TIME | C020_FLIGHT_LEVEL, 0});
+    m_decoder.addProjection({"modes", C048_ADDRESS | C048_MODE_S, 0, 0, 0, 0, C020_ADDRESS | C020_MODE_S, 0});
+    m_decoder.addProjection({"fusion", C048_ADDRESS | C048_MODE3A, 0, C021_MODE3A,
+                             C062_MODE3A | C062_DERIVED, 0, C020_MODE3A, 0});
+    m_videoDecoder.addProjection({"video", 0, 0, 0, 0, ~0u, 0, 0});
+    // CAT048 is decoded as columns and scaled in bulk; the projections above
+    // still decide which column items are parsed (the rest are only located)
+    m_decoder.setColumnar048(true);
+    Logger::debug("[MARS] CAT048 column conversion kernel: {}", PlotColumns::kernel());
+
+    if (m_config.video_enabled) {
+        m_video.reset(new VideoRaster(m_config.video_raster_size));
+        m_video->setRange(m_config.video_range_nm * NM_TO_M);
+    }
+    Logger::debug("[MARS] Decode projection: CAT048 0x{:x}, CAT034 0x{:x}, CAT021 0x{:x}, CAT062 0x{:x}, "
+                  "CAT020 0x{:x}, CAT019 0x{:x}",
+                  m_decoder.projection048(), m_decoder.projection034(), m_decoder.projection021(),
+                  m_decoder.projection062(), m_decoder.projection020(), m_decoder.projection019());
 }
 
 MarsEngine::~MarsEngine() { 
@@ -70,13 +160,15 @@ void MarsEngine::start() {
     if (m_isRunning) return;
     m_isRunning = true;
     m_workerThread = std::thread(&MarsEngine::processLoop, this);
+    if (m_video) m_videoThread = std::thread(&MarsEngine::videoLoop, this);
     Logger::info("[MARS] Engine Started. Listening on interface: {}", m_config.interface);
 }
 
 void MarsEngine::stop() {
     m_isRunning = false;
-    if (system("pkill -f 'tshark -l -n -i'") != 0) {} 
     if (m_workerThread.joinable()) m_workerThread.join();
+    m_videoCv.notify_all();
+    if (m_videoThread.joinable()) m_videoThread.join();
     if (m_udpSock != -1) close(m_udpSock);
     cleanupSSL();
     Logger::info("[MARS] Engine Stopped.");
@@ -164,13 +256,17 @@ void MarsEngine::manageTcpConnection() {
         }
         m_currentHost = m_config.cot_ip;
         m_currentPort = m_config.cot_port;
+        // A new server is tried straight away
+        m_timers.cancel(m_reconnectTimer);
+        m_reconnectBackoffMs = RECONNECT_MIN_MS;
     }
 
     if (m_tcpConnected) return;
 
-    auto now = std::chrono::steady_clock::now();
-    if (std::chrono::duration_cast<std::chrono::seconds>(now - m_lastTcpAttempt).count() < 5) return;
-    m_lastTcpAttempt = now;
+    // Backoff: the next attempt waits for TIMER_RECONNECT, armed before this one
+    if (m_timers.pending(m_reconnectTimer)) return;
+    m_reconnectTimer = m_timers.schedule(m_reconnectBackoffMs, TIMER_RECONNECT);
+    m_reconnectBackoffMs = std::min(m_reconnectBackoffMs * 2, RECONNECT_MAX_MS);
 
     bool useSSL = (m_config.cot_protocol == "ssl");
     if (useSSL && !m_sslCtx) {
@@ -218,30 +314,24 @@ void MarsEngine::manageTcpConnection() {
     }
 
     m_tcpConnected = true;
+    m_timers.cancel(m_reconnectTimer);
+    m_reconnectBackoffMs = RECONNECT_MIN_MS;
 }
 
 // --- SEND HELPER ---
 void MarsEngine::sendToTak(const std::string& xml) {
     if (!m_config.send_tak_tracks && !m_config.send_sensor_pos) return;
 
-    if (m_config.cot_protocol == "tcp" || m_config.cot_protocol == "ssl") {
-        manageTcpConnection();
-        
-        if (m_tcpConnected) {
-            std::string payload = xml + "\n";
-            int ret = -1;
+    if (m_cotBatching) {
+        m_cotBatch += xml;
+        if (m_config.cot_protocol == "tcp" || m_config.cot_protocol == "ssl") m_cotBatch += '\n';
+        m_cotBatchEnds.push_back(m_cotBatch.size());
+        return;
+    }
 
-            if (m_config.cot_protocol == "ssl" && m_ssl) {
-                ret = SSL_write(m_ssl, payload.c_str(), payload.length());
-            } else {
-                ret = send(m_tcpSock, payload.c_str(), payload.length(), 0);
-            }
-            
-            if (ret <= 0) {
-                Logger::error("[MARS] Send failed. Reconnecting...");
-                cleanupSSL(); 
-            }
-        }
+    if (m_config.cot_protocol == "tcp" || m_config.cot_protocol == "ssl") {
+        std::string payload = xml + "\n";
+        writeTak(payload.c_str(), payload.length());
     } 
     else {
         struct sockaddr_in udpAddr;
@@ -253,6 +343,517 @@ void MarsEngine::sendToTak(const std::string& xml) {
     }
 }
 
+void MarsEngine::writeTak(const char* data, size_t len) {
+    manageTcpConnection();
+    if (!m_tcpConnected) return;
+
+    int ret = -1;
+    if (m_config.cot_protocol == "ssl" && m_ssl) {
+        ret = SSL_write(m_ssl, data, int(len));
+    } else {
+        ret = send(m_tcpSock, data, len, 0);
+    }
+
+    if (ret <= 0) {
+        Logger::error("[MARS] Send failed. Reconnecting...");
+        cleanupSSL(); 
+    }
+}
+
+// Events generated while decoding one datagram go out together: one write on
+// a stream connection, one sendmmsg() call per 64 events over UDP
+void MarsEngine::beginCotBatch() {
+    m_cotBatching = true;
+    m_cotBatch.clear();
+    m_cotBatchEnds.clear();
+}
+
+void MarsEngine::flushCotBatch() {
+    m_cotBatching = false;
+    if (m_cotBatchEnds.empty()) return;
+
+    if (m_config.cot_protocol == "tcp" || m_config.cot_protocol == "ssl") {
+        writeTak(m_cotBatch.data(), m_cotBatch.size());
+    } else {
+        struct sockaddr_in udpAddr;
+        memset(&udpAddr, 0, sizeof(udpAddr));
+        udpAddr.sin_family = AF_INET;
+        udpAddr.sin_port = htons(m_config.cot_port);
+        inet_pton(AF_INET, m_config.cot_ip.c_str(), &udpAddr.sin_addr);
+
+        constexpr size_t CHUNK = 64;
+        struct iovec iovs[CHUNK];
+        struct mmsghdr msgs[CHUNK];
+        size_t start = 0;
+        for (size_t i = 0; i < m_cotBatchEnds.size();) {
+            size_t n = 0;
+            for (; n < CHUNK && i < m_cotBatchEnds.size(); ++n, ++i) {
+                iovs[n].iov_base = &m_cotBatch[start];
+                iovs[n].iov_len = m_cotBatchEnds[i] - start;
+                memset(&msgs[n], 0, sizeof(msgs[n]));
+                msgs[n].msg_hdr.msg_iov = &iovs[n];
+                msgs[n].msg_hdr.msg_iovlen = 1;
+                msgs[n].msg_hdr.msg_name = &udpAddr;
+                msgs[n].msg_hdr.msg_namelen = sizeof(udpAddr);
+                start = m_cotBatchEnds[i];
+            }
+            sendmmsg(m_udpSock, msgs, unsigned(n), 0);
+        }
+    }
+    m_cotBatch.clear();
+    m_cotBatchEnds.clear();
+}
+
+// --- SHARED OUTPUT ---
+void MarsEngine::relayAsterix(const void* data, size_t len) {
+    if (!m_config.send_asterix) return;
+    struct sockaddr_in astAddr;
+    memset(&astAddr, 0, sizeof(astAddr));
+    astAddr.sin_family = AF_INET;
+    astAddr.sin_port = htons(m_config.asterix_port);
+    inet_pton(AF_INET, m_config.asterix_ip.c_str(), &astAddr.sin_addr);
+    sendto(m_astSock, data, len, 0, (struct sockaddr*)&astAddr, sizeof(astAddr));
+}
+
+void MarsEngine::pushWeb(const PlotReport& r, long trackRow) {
+    WebRecord w;
+    w.category = r.category;
+    if (r.hasSource) { w.sac = r.sac; w.sic = r.sic; w.flags |= WEB_SOURCE; }
+    if (r.timeOfDay >= 0) { w.timeOfDay = r.timeOfDay; w.flags |= WEB_TIME; }
+    if (r.isGeo || r.isProjected) { w.lat = r.lat; w.lon = r.lon; w.flags |= WEB_GEO; }
+    else if (const SensorOrigin* site = (r.isPolar && r.rho >= 0) ? origin(r.sac, r.sic) : nullptr) {
+        polarToGeo(site->lat, site->lon, r.rho, r.theta, w.lat, w.lon);
+        w.flags |= WEB_GEO;
+    }
+    if (r.isPolar) { w.rho = r.rho; w.theta = r.theta; w.flags |= WEB_POLAR; }
+    if (r.hasVelocity) { w.speed = r.speed; w.heading = r.course; w.flags |= WEB_VELOCITY; }
+    if (r.hasFlightLevel) { w.flightLevel = r.flightLevel; w.flags |= WEB_FLIGHT_LEVEL; }
+    snprintf(w.id, sizeof(w.id), "%s", r.id.c_str());
+    snprintf(w.callsign, sizeof(w.callsign), "%s", r.callsign.c_str());
+    if (trackRow >= 0) {
+        // Tracks go out as the store has them: position resolved, callsign
+        // kept, and under their fused track once associated
+        const TrackStore* store = &m_tracks;
+        size_t row = size_t(trackRow);
+        long fused = m_tracks.link[row] ? m_fused.find(m_tracks.link[row]) : -1;
+        if (fused >= 0) { store = &m_fused; row = size_t(fused); }
+        const TrackStore& t = *store;
+        t.uid(row, w.uid, sizeof(w.uid));
+        if (t.flags[row] & TRK_POSITION) { w.lat = t.lat[row]; w.lon = t.lon[row]; w.flags |= WEB_GEO; }
+        if (t.flags[row] & TRK_VELOCITY) {
+            double course = atan2(t.vx[row], t.vy[row]) * 180.0 / PI;
+            w.speed = std::hypot(t.vx[row], t.vy[row]);
+            w.heading = course < 0 ? course + 360.0 : course;
+            w.flags |= WEB_VELOCITY;
+        }
+        if (t.flags[row] & TRK_FLIGHT_LEVEL) { w.flightLevel = t.flightLevel[row]; w.flags |= WEB_FLIGHT_LEVEL; }
+        snprintf(w.callsign, sizeof(w.callsign), "%s", t.callsignOf(row));
+    }
+    if (r.modeS) {
+        // The Comm-B values the map shows, as far as they are known
+        const ModeSData& ms = *r.modeS;
+        const WebRecord::Extra extras[] = {{"SEL_ALT", ms.selectedAltitude}, {"ROLL", ms.roll},
+                                           {"TRACK_RATE", ms.trackRate},     {"IAS", ms.ias},
+                                           {"MACH", ms.mach},                {"MAG_HDG", ms.magHeading}};
+        const uint16_t flags[] = {MS_SELECTED_ALTITUDE, MS_ROLL, MS_TRACK_RATE, MS_IAS, MS_MACH, MS_MAG_HEADING};
+        for (size_t i = 0; i < std::size(flags) && w.extraCount < WebRecord::MAX_EXTRAS; ++i) {
+            if (ms.present & flags[i]) w.extras[w.extraCount++] = extras[i];
+        }
+    }
+    m_web.push(w);
+}
+
+// Spec-decoded categories have no typed fields: the first values go out by name
+void MarsEngine::pushWeb(const SpecRecord& rec, const AsterixDecodeResult& decoded) {
+    const UapSpec* spec = m_decoder.spec();
+    WebRecord w;
+    w.category = rec.category;
+    if (rec.hasSource) { w.sac = rec.sac; w.sic = rec.sic; w.flags |= WEB_SOURCE; }
+    for (uint32_t i = 0; i < rec.valueCount && w.extraCount < WebRecord::MAX_EXTRAS; ++i) {
+        const SpecValue& v = decoded.values[rec.firstValue + i];
+        const char* name = spec->fieldName(v.field).c_str();
+        bool seen = false;   // Repetitive items: first repetition only
+        for (int k = 0; k < w.extraCount && !seen; ++k) seen = (w.extras[k].name == name);
+        if (!seen) w.extras[w.extraCount++] = {name, v.value};
+    }
+    m_web.push(w);
+}
+
+void MarsEngine::pushVideo(const PacketRef& pkt) {
+    if (!m_video) return;
+    {
+        // Falling behind drops the oldest sweep data, never plots
+        size_t cap = std::min<size_t>(1024, m_pool.stats().capacity / 4);
+        std::lock_guard<std::mutex> lock(m_videoMutex);
+        m_videoQueue.push_back(pkt);
+        if (m_videoQueue.size() > cap) m_videoQueue.pop_front();
+    }
+    m_videoCv.notify_one();
+}
+
+void MarsEngine::videoLoop() {
+    AsterixDecodeResult decoded;
+    std::deque<PacketRef> batch;
+    while (m_isRunning) {
+        {
+            std::unique_lock<std::mutex> lock(m_videoMutex);
+            m_videoCv.wait_for(lock, std::chrono::milliseconds(250),
+                               [this] { return !m_videoQueue.empty() || !m_isRunning; });
+            batch.swap(m_videoQueue);
+        }
+        for (const auto& pkt : batch) {
+            decoded.clear();
+            if (!m_videoDecoder.decode(pkt.payload(), pkt.payloadLen(), decoded)) continue;
+            for (const auto& rec : decoded.cat240) m_video->update(rec);
+        }
+        batch.clear();
+    }
+}
+
+void MarsEngine::handleReport(const PlotReport& r, double now) {
+    if (r.isGeo && (r.id.empty() || r.id == "0")) setOrigin(r.sac, r.sic, r.lat, r.lon);
+    // A polar plot is placed from its own radar's site; until that is known it is dropped
+    if (r.isPolar && !r.isGeo && !r.isProjected && !origin(r.sac, r.sic)) return;
+    if (r.trackKey == 0) { pushWeb(r); return; }
+
+    std::string cot;
+    {
+        std::lock_guard<std::mutex> lock(m_trackMutex);
+        bool moved;
+        size_t row = updateTrack(r, now, &moved);
+        // A new position is folded into the track's fused track (TrackFusion)
+        if (moved) {
+            bool created;
+            size_t fused = m_fusion.associate(m_tracks, row, m_fused, now, &created);
+            if (created) m_timers.schedule(TRACK_TIMEOUT_MS, TIMER_FUSED_EXPIRY, m_fused.trackKey[fused]);
+            // With a tick rate the tick sends extrapolated positions instead (sendTrackTick)
+            if (m_config.send_tak_tracks && m_config.tick_rate_ms <= 0) {
+                cot = trackCot(m_fused, fused, m_fused.lat[fused], m_fused.lon[fused]);
+            }
+        }
+        pushWeb(r, long(row));
+    }
+    if (!cot.empty()) sendToTak(cot);
+}
+
+// Fold one report into its track row (caller holds m_trackMutex); '*moved'
+// is set when the report positioned it
+size_t MarsEngine::updateTrack(const PlotReport& r, double now, bool* moved) {
+    TrackStore& t = m_tracks;
+    bool created;
+    size_t row = t.upsert(r.trackKey, now, &created);
+    // One expiry timer per track, re-armed lazily when it fires (expireTrack)
+    if (created) m_timers.schedule(TRACK_TIMEOUT_MS, TIMER_TRACK_EXPIRY, r.trackKey);
+    t.category[row] = r.category;
+    if (r.timeOfDay >= 0) t.timeOfDay[row] = r.timeOfDay;
+
+    double velocity[2];
+    if (r.hasVelocity) {
+        double course = r.course * PI / 180.0;
+        velocity[0] = r.speed * sin(course);
+        velocity[1] = r.speed * cos(course);
+    }
+    // Positions go through the track's filter, timed by arrival
+    double lat, lon;
+    bool hasPosition = true;
+    const SensorOrigin* site = (r.isPolar && r.rho >= 0) ? origin(r.sac, r.sic) : nullptr;
+    if (r.isGeo || r.isProjected) { lat = r.lat; lon = r.lon; }
+    else if (site) polarToGeo(site->lat, site->lon, r.rho, r.theta, lat, lon);
+    else hasPosition = false;
+
+    *moved = hasPosition;
+    if (hasPosition) {
+        t.filterUpdate(row, lat, lon, now, r.hasVelocity ? velocity : nullptr);
+    } else if (r.hasVelocity) {
+        t.vx[row] = velocity[0]; t.vy[row] = velocity[1];
+        t.flags[row] |= TRK_VELOCITY;
+    }
+    if (r.hasFlightLevel) { t.flightLevel[row] = r.flightLevel; t.flags[row] |= TRK_FLIGHT_LEVEL; }
+    if (r.hasAddress) { t.address[row] = r.address; t.flags[row] |= TRK_ADDRESS; }
+    if (r.hasMode3A) { t.mode3A[row] = r.mode3A; t.flags[row] |= TRK_MODE3A; }
+    snprintf(t.labelOf(row), TrackStore::LABEL_LEN, "%s", r.id.c_str());
+    if (!r.callsign.empty()) snprintf(t.callsignOf(row), TrackStore::CALLSIGN_LEN, "%s", r.callsign.c_str());
+    return row;
+}
+
+std::string MarsEngine::trackCot(const TrackStore& t, size_t row, double lat, double lon) const {
+    char uid[40];
+    t.uid(row, uid, sizeof(uid));
+    const char* name = t.callsignOf(row)[0] ? t.callsignOf(row) : t.labelOf(row);
+
+    std::stringstream xml;
+    xml << "<event version='2.0' uid='" << uid << "' type='a-u-G' how='m-g' time='" << getIsoTime(0) << "' start='" << getIsoTime(0) << "' stale='" << getIsoTime(5) << "'>"
+        << "<point lat='" << lat << "' lon='" << lon << "' hae='0' ce='25' le='25'/>"
+        << "<detail><contact callsign='" << name << "'/>";
+    if (t.flags[row] & TRK_VELOCITY) {
+        double course = atan2(t.vx[row], t.vy[row]) * 180.0 / PI;
+        xml << "<track course='" << (course < 0 ? course + 360.0 : course) << "' speed='" << std::hypot(t.vx[row], t.vy[row]) << "'/>";
+    }
+    // Comm-B values of the aircraft, under the same names as the exports
+    double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (const ModeSData* ms = (t.flags[row] & TRK_ADDRESS) ? currentModeS(t.address[row], now) : nullptr) {
+        xml << "<modes";
+        for (const auto& v : MODE_S_VALUES) {
+            if (ms->present & v.flag) xml << ' ' << v.name << "='" << ms->*v.value << "'";
+        }
+        xml << "/>";
+    }
+    xml << "</detail></event>";
+    return xml.str();
+}
+
+void MarsEngine::exportTracks(std::string& out, bool csv) const {
+    double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    char buf[320], uid[40], fused[40];
+    out.clear();
+    if (csv) {
+        out += "uid,category,sac,sic,id,callsign,lat,lon,speed_mps,course_deg,flight_level,time_of_day,age_s,updates,fused";
+        for (const auto& v : MODE_S_VALUES) { out += ','; out += v.name; }
+        out += '\n';
+    } else {
+        out += '[';
+    }
+
+    std::lock_guard<std::mutex> lock(m_trackMutex);
+    std::lock_guard<std::mutex> adsbLock(m_adsbMutex);
+    bool first = true;
+    auto exportRows = [&](const TrackStore& t) {
+        for (size_t row = 0; row < t.count; ++row) {
+            t.uid(row, uid, sizeof(uid));
+            // Sensor tracks name the fused track they are in
+            long fusedRow = t.link[row] ? m_fused.find(t.link[row]) : -1;
+            fused[0] = 0;
+            if (fusedRow >= 0) m_fused.uid(size_t(fusedRow), fused, sizeof(fused));
+            uint8_t flags = t.flags[row];
+            double course = atan2(t.vx[row], t.vy[row]) * 180.0 / PI;
+            if (course < 0) course += 360.0;
+            double speed = std::hypot(t.vx[row], t.vy[row]);
+            double age = now - t.lastUpdate[row];
+            uint64_t key = t.trackKey[row];
+            TrackKind kind = TrackStore::kindOf(key);
+            bool hasSource = kind != TRACK_ADDRESS && kind != TRACK_FUSED;
+            const ModeSData* ms = (flags & TRK_ADDRESS) ? currentModeS(t.address[row], now) : nullptr;
+            int len;
+            if (csv) {
+                // Unknown values stay empty
+                len = snprintf(buf, sizeof(buf), "%s,%u,", uid, unsigned(t.category[row]));
+                out.append(buf, len);
+                if (hasSource) { len = snprintf(buf, sizeof(buf), "%u,%u,", unsigned(TrackStore::sacOf(key)), unsigned(TrackStore::sicOf(key))); out.append(buf, len); }
+                else out += ",,";
+                len = snprintf(buf, sizeof(buf), "%s,%s,", t.labelOf(row), t.callsignOf(row));
+                out.append(buf, len);
+                if (flags & TRK_POSITION) { len = snprintf(buf, sizeof(buf), "%.6f,%.6f,", t.lat[row], t.lon[row]); out.append(buf, len); }
+                else out += ",,";
+                if (flags & TRK_VELOCITY) { len = snprintf(buf, sizeof(buf), "%.2f,%.2f,", speed, course); out.append(buf, len); }
+                else out += ",,";
+                if (flags & TRK_FLIGHT_LEVEL) { len = snprintf(buf, sizeof(buf), "%.2f", t.flightLevel[row]); out.append(buf, len); }
+                out += ',';
+                if (t.timeOfDay[row] >= 0) { len = snprintf(buf, sizeof(buf), "%.3f", t.timeOfDay[row]); out.append(buf, len); }
+                len = snprintf(buf, sizeof(buf), ",%.1f,%u,%s", age, unsigned(t.quality[row]), fused);
+                out.append(buf, len);
+                for (const auto& v : MODE_S_VALUES) {
+                    out += ',';
+                    if (ms && (ms->present & v.flag)) { len = snprintf(buf, sizeof(buf), v.format, ms->*v.value); out.append(buf, len); }
+                }
+                out += '\n';
+                continue;
+            }
+            if (!first) out += ',';
+            first = false;
+            len = snprintf(buf, sizeof(buf), "{\"uid\":\"%s\",\"cat\":%u,\"id\":\"%s\"", uid, unsigned(t.category[row]), t.labelOf(row));
+            out.append(buf, len);
+            if (hasSource) { len = snprintf(buf, sizeof(buf), ",\"sac\":%u,\"sic\":%u", unsigned(TrackStore::sacOf(key)), unsigned(TrackStore::sicOf(key))); out.append(buf, len); }
+            if (t.callsignOf(row)[0]) { len = snprintf(buf, sizeof(buf), ",\"cs\":\"%s\"", t.callsignOf(row)); out.append(buf, len); }
+            if (flags & TRK_POSITION) { len = snprintf(buf, sizeof(buf), ",\"lat\":%.6f,\"lon\":%.6f", t.lat[row], t.lon[row]); out.append(buf, len); }
+            if (flags & TRK_VELOCITY) { len = snprintf(buf, sizeof(buf), ",\"spd\":%.2f,\"hdg\":%.2f", speed, course); out.append(buf, len); }
+            if (flags & TRK_FLIGHT_LEVEL) { len = snprintf(buf, sizeof(buf), ",\"fl\":%.2f", t.flightLevel[row]); out.append(buf, len); }
+            if (flags & TRK_ADDRESS) { len = snprintf(buf, sizeof(buf), ",\"addr\":\"%06X\"", t.address[row]); out.append(buf, len); }
+            if (flags & TRK_MODE3A) { len = snprintf(buf, sizeof(buf), ",\"sq\":\"%04o\"", unsigned(t.mode3A[row])); out.append(buf, len); }
+            if (t.timeOfDay[row] >= 0) { len = snprintf(buf, sizeof(buf), ",\"tod\":%.3f", t.timeOfDay[row]); out.append(buf, len); }
+            if (fused[0]) { len = snprintf(buf, sizeof(buf), ",\"fused\":\"%s\"", fused); out.append(buf, len); }
+            if (ms) {
+                const char* sep = ",\"modes\":{";
+                for (const auto& v : MODE_S_VALUES) {
+                    if (!(ms->present & v.flag)) continue;
+                    len = snprintf(buf, sizeof(buf), "%s\"%s\":", sep, v.name);
+                    out.append(buf, len);
+                    len = snprintf(buf, sizeof(buf), v.format, ms->*v.value);
+                    out.append(buf, len);
+                    sep = ",";
+                }
+                out += '}';
+            }
+            len = snprintf(buf, sizeof(buf), ",\"age\":%.1f,\"q\":%u}", age, unsigned(t.quality[row]));
+            out.append(buf, len);
+        }
+    };
+    exportRows(m_tracks);
+    exportRows(m_fused);
+    if (!csv) out += ']';
+}
+
+void MarsEngine::startTimers() {
+    m_timers = TimingWheel(steadyMs());
+    m_reconnectTimer = 0;
+    m_reconnectBackoffMs = RECONNECT_MIN_MS;
+    {
+        // Track timers do not survive a restart, so neither do the tracks
+        std::lock_guard<std::mutex> lock(m_trackMutex);
+        m_tracks.clear();
+        m_fused.clear();
+    }
+    m_timers.schedule(SENSOR_COT_MS, TIMER_SENSOR_COT);
+    m_timers.schedule(HEARTBEAT_MS, TIMER_HEARTBEAT);
+    m_timers.schedule(HOUSEKEEPING_MS, TIMER_HOUSEKEEPING);
+    m_timers.schedule(trackTickMs(), TIMER_TRACK_TICK);
+    m_timers.schedule(FUSION_GRID_MS, TIMER_FUSION_GRID);
+}
+
+void MarsEngine::serviceTimers() {
+    uint64_t nowMs = steadyMs();
+    m_firedTimers.clear();
+    m_timers.advance(nowMs, m_firedTimers);
+    for (const auto& timer : m_firedTimers) {
+        switch (timer.kind) {
+            case TIMER_TRACK_EXPIRY:
+                expireTrack(m_tracks, TIMER_TRACK_EXPIRY, timer.payload, nowMs);
+                break;
+            case TIMER_FUSED_EXPIRY:
+                expireTrack(m_fused, TIMER_FUSED_EXPIRY, timer.payload, nowMs);
+                break;
+            case TIMER_FUSION_GRID: {
+                std::lock_guard<std::mutex> lock(m_trackMutex);
+                m_fusion.rebuild(m_fused, nowMs / 1000.0);
+                m_timers.schedule(FUSION_GRID_MS, TIMER_FUSION_GRID);
+                break;
+            }
+            case TIMER_SENSOR_COT:
+                sendSensorCot();
+                m_timers.schedule(SENSOR_COT_MS, TIMER_SENSOR_COT);
+                break;
+            case TIMER_HEARTBEAT:
+                sendHeartbeat();
+                m_timers.schedule(HEARTBEAT_MS, TIMER_HEARTBEAT);
+                break;
+            case TIMER_HOUSEKEEPING:
+                // ADS-B aircraft silent for a minute are forgotten
+                {
+                    std::lock_guard<std::mutex> lock(m_adsbMutex);
+                    m_adsb.expire(nowMs / 1000.0, 60.0);
+                }
+                m_timers.schedule(HOUSEKEEPING_MS, TIMER_HOUSEKEEPING);
+                break;
+            case TIMER_TRACK_TICK:
+                sendTrackTick(nowMs);
+                m_timers.schedule(trackTickMs(), TIMER_TRACK_TICK);
+                break;
+            case TIMER_RECONNECT:
+                break;   // Backoff over: manageTcpConnection() below tries again
+        }
+    }
+    if(m_config.cot_protocol != "udp") manageTcpConnection();
+}
+
+// A track's timer fires TRACK_TIMEOUT_MS after it was armed. Reports since
+// then only moved lastUpdate, so the timer is re-armed for the remainder
+// instead of being rescheduled on every report.
+void MarsEngine::expireTrack(TrackStore& store, uint16_t kind, uint64_t key, uint64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_trackMutex);
+    long row = store.find(key);
+    if (row < 0) return;
+    double idleMs = nowMs - store.lastUpdate[row] * 1000.0;
+    if (idleMs < double(TRACK_TIMEOUT_MS)) {
+        m_timers.schedule(TRACK_TIMEOUT_MS - uint64_t(std::max(idleMs, 0.0)), kind, key);
+        return;
+    }
+    // The map shows fused tracks: it drops one now rather than on its own
+    // clock. A sensor track just leaves its fused track's members.
+    if (&store == &m_fused) {
+        WebRecord w;
+        w.category = store.category[row];
+        w.flags = WEB_DROPPED;
+        store.uid(size_t(row), w.uid, sizeof(w.uid));
+        m_web.push(w);
+    }
+    store.erase(key);
+}
+
+// AppConfig::tick_rate_ms, at least 100 ms; 0 or less sends CoT per report
+// and the timer only looks again for a config change once a second
+uint64_t MarsEngine::trackTickMs() const {
+    int tick = m_config.tick_rate_ms;
+    return tick <= 0 ? 1000 : uint64_t(std::max(tick, 100));
+}
+
+// Every fused track at its position extrapolated to now: TAK sees steady
+// motion at a fixed rate rather than jumps at each radar scan
+void MarsEngine::sendTrackTick(uint64_t nowMs) {
+    if (!m_config.send_tak_tracks || m_config.tick_rate_ms <= 0) return;
+    beginCotBatch();
+    {
+        std::lock_guard<std::mutex> lock(m_trackMutex);
+        TrackStore& t = m_fused;
+        t.predict(nowMs / 1000.0);
+        for (size_t row = 0; row < t.count; ++row) {
+            if (t.flags[row] & TRK_POSITION) sendToTak(trackCot(t, row, t.predLat[row], t.predLon[row]));
+        }
+    }
+    flushCotBatch();
+}
+
+// --- SENSOR ORIGINS ---
+const MarsEngine::SensorOrigin* MarsEngine::origin(uint8_t sac, uint8_t sic) const {
+    uint16_t source = uint16_t(sac << 8 | sic);
+    for (const auto& o : m_origins) {
+        if (o.source == source) return &o;
+    }
+    return nullptr;
+}
+
+void MarsEngine::setOrigin(uint8_t sac, uint8_t sic, double lat, double lon) {
+    uint16_t source = uint16_t(sac << 8 | sic);
+    auto it = std::find_if(m_origins.begin(), m_origins.end(), [source](const SensorOrigin& o) { return o.source == source; });
+    if (it == m_origins.end()) {
+        Logger::info("[MARS] Sensor {}/{} located at {:.5f}, {:.5f}", sac, sic, lat, lon);
+        m_origins.push_back({source, lat, lon});
+    } else {
+        it->lat = lat; it->lon = lon;
+    }
+    if (m_video) m_video->setOrigin(sac, sic, lat, lon);
+}
+
+// One marker per located radar
+void MarsEngine::sendSensorCot() {
+    if (!m_config.send_sensor_pos || m_origins.empty()) return;
+    beginCotBatch();
+    for (const auto& o : m_origins) {
+        unsigned sac = o.source >> 8, sic = o.source & 0xFF;
+        std::stringstream xml;
+        xml << "<event version='2.0' uid='SENSOR-ORIGIN-" << sac << "-" << sic << "' type='a-f-G-U-H' how='m-g' time='" << getIsoTime(0) << "' start='" << getIsoTime(0) << "' stale='" << getIsoTime(20) << "'>"
+            << "<point lat='" << o.lat << "' lon='" << o.lon << "' hae='0' ce='10' le='10'/>"
+            << "<detail><contact callsign='GNE " << sac << "/" << sic << "'/></detail></event>";
+        sendToTak(xml.str());
+    }
+    flushCotBatch();
+}
+
+// TAK server keepalive (t-x-c-t ping), only on an open stream connection
+void MarsEngine::sendHeartbeat() {
+    if (m_config.cot_protocol == "udp" || !m_tcpConnected) return;
+    std::stringstream xml;
+    xml << "<event version='2.0' uid='GNE-ping' type='t-x-c-t' how='h-g-i-g-o' time='" << getIsoTime(0) << "' start='" << getIsoTime(0) << "' stale='" << getIsoTime(20) << "'>"
+        << "<point lat='0' lon='0' hae='0' ce='9999999' le='9999999'/><detail/></event>";
+    sendToTak(xml.str());
+}
+
+// Time until the wheel has a slot due, capped so config changes and stop()
+// are noticed promptly
+int MarsEngine::nextTimerMs() const {
+    uint64_t behind = steadyMs() - m_timers.now();
+    uint64_t due = m_timers.nextDueMs(250);
+    return int(due > behind ? due - behind : 0);
+}
+
 // --- PROCESS LOOP ---
 void MarsEngine::processLoop() {
     m_udpSock = socket(AF_INET, SOCK_DGRAM, 0);
@@ -260,107 +861,505 @@ void MarsEngine::processLoop() {
     unsigned char ttl=64; setsockopt(m_udpSock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
     int bcast=1; setsockopt(m_udpSock, SOL_SOCKET, SO_BROADCAST, &bcast, sizeof(bcast));
 
-    int sockAst = socket(AF_INET, SOCK_DGRAM, 0);
-    setsockopt(sockAst, SOL_SOCKET, SO_BROADCAST, &bcast, sizeof(bcast));
-    struct sockaddr_in astAddr;
+    m_astSock = socket(AF_INET, SOCK_DGRAM, 0);
+    setsockopt(m_astSock, SOL_SOCKET, SO_BROADCAST, &bcast, sizeof(bcast));
 
-    std::string filter = "udp port " + std::to_string(m_config.rx_port);
-    std::string cmd = "tshark -l -n -i " + m_config.interface + " -f \"" + filter + "\" "
-                      "-T ek -d udp.port==" + std::to_string(m_config.rx_port) + ",asterix";
+    startTimers();
 
-    Logger::info("[MARS] Launching Tshark: {}", cmd);
-    FILE* pipe = popen(cmd.c_str(), "r");
-    if (!pipe) { Logger::error("[MARS] Failed to start Tshark!"); return; }
+    // Every back-end decodes from the shared ingest, so relay, multiple
+    // inputs and the capture ring work the same in all of them
+    bool tshark = (m_config.decoder_mode == "tshark" || m_config.decoder_mode == "tshark-fields");
+    startIngest();
+    if (tshark) runTsharkPoolLoop();
+    else runDecodeLoop();
+    stopIngest();
 
-    char buffer[65536];
-    auto lastOriginCoT = std::chrono::steady_clock::now();
+    cleanupSSL();
+    close(m_astSock); m_astSock = -1;
+}
 
-    while (m_isRunning && pipe) {
-        memset(&astAddr, 0, sizeof(astAddr)); 
-        astAddr.sin_family=AF_INET; 
-        astAddr.sin_port=htons(m_config.asterix_port); 
-        inet_pton(AF_INET, m_config.asterix_ip.c_str(), &astAddr.sin_addr);
+// --- INGEST ---
+void MarsEngine::startIngest() {
+    // The ring is bound to one interface, so it only feeds the decoder for a single input
+    if (m_ring && m_config.inputs.size() <= 1) {
+        Logger::info("[MARS] Reading ASTERIX from shared capture ring");
+        // The ring thread only queues a handle; decoding happens on processLoop
+        InputCounters& counters = m_inputCounters[0];
+        m_ringSinkId = m_ring->addSink([this, &counters](const PacketRef& pkt) {
+            if (pkt->payloadLen == 0 || pkt->outgoing) return;
+            counters.datagrams.fetch_add(1, std::memory_order_relaxed);
+            if (pkt->len < pkt->origLen) {
+                // Cut short by buffer_size: as on the sockets, a partial block is dropped
+                counters.truncated.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_ingestMutex);
+                m_ingestQueue.push_back(pkt);
+            }
+            notifyIngest();
+        });
+        return;
+    }
 
-        if(m_config.cot_protocol != "udp") manageTcpConnection();
+    // One receive thread per input
+    for (size_t i = 0; i < m_config.inputs.size(); ++i) {
+        m_rxThreads.emplace_back(&MarsEngine::receiveLoop, this, i);
+    }
+}
 
-        if (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-            try {
-                if (m_config.send_asterix) {
-                     std::string jsonStr(buffer);
-                     sendto(sockAst, jsonStr.c_str(), jsonStr.length(), 0, (struct sockaddr*)&astAddr, sizeof(astAddr));
-                }
+void MarsEngine::stopIngest() {
+    if (m_ringSinkId != -1) { m_ring->removeSink(m_ringSinkId); m_ringSinkId = -1; }
+    for (auto& t : m_rxThreads) if (t.joinable()) t.join();
+    m_rxThreads.clear();
+    std::lock_guard<std::mutex> lock(m_ingestMutex);
+    m_ingestQueue.clear();
+    int efd = m_ingestEventFd.exchange(-1);
+    if (efd >= 0) close(efd);
+}
 
-                nlohmann::json raw = nlohmann::json::parse(buffer);
-                if (!raw.contains("layers") || !raw["layers"].contains("asterix")) continue;
+void MarsEngine::receiveLoop(size_t index) {
+    const InputConfig& input = m_config.inputs[index];
+    UdpReceiver::Options opts;
+    opts.interface = input.interface;
+    opts.port = input.port;
+    opts.group = input.group;
+    opts.batchSize = m_config.recv_batch_size;
+    opts.rcvBufBytes = m_config.recv_socket_buffer;
+    opts.reusePort = std::count_if(m_config.inputs.begin(), m_config.inputs.end(),
+                                   [&](const InputConfig& o) { return o.port == input.port; }) > 1;
 
-                {
-                    std::lock_guard<std::mutex> lock(m_queueMutex);
-                    m_webQueue.push_back(raw);
-                    if(m_webQueue.size() > 500) m_webQueue.pop_front();
-                }
+    UdpReceiver rx;
+    if (!rx.open(opts, m_pool)) { Logger::error("[MARS] Input '{}' unavailable!", input.label); return; }
+    Logger::info("[MARS] Input '{}' receiving on UDP {}", input.label, input.port);
+    {
+        std::lock_guard<std::mutex> lock(m_rxMutex);
+        rx.setFilter(AsterixSelect{m_config.active_categories, m_config.allowed_sources});
+        m_receivers.push_back(&rx);
+    }
 
-                auto ast = raw["layers"]["asterix"];
-                std::string id = "";
-                double lat=0, lon=0, rho=-1, theta=0;
-                bool isGeo=false, isPolar=false;
-
-                for (auto& [key, val] : ast.items()) {
-                    if (key.find("120_LAT")!=std::string::npos) { lat=val.is_string()?std::stod(val.get<std::string>()):val.get<double>(); isGeo=true; }
-                    if (key.find("120_LON")!=std::string::npos) { lon=val.is_string()?std::stod(val.get<std::string>()):val.get<double>(); isGeo=true; }
-                    if (key.find("040_RHO")!=std::string::npos) { rho=val.is_string()?std::stod(val.get<std::string>()):val.get<double>(); isPolar=true; }
-                    if (key.find("040_THETA")!=std::string::npos) { theta=val.is_string()?std::stod(val.get<std::string>()):val.get<double>(); isPolar=true; }
-                    if (key.find("161_TN")!=std::string::npos) {
-                        if(val.is_number()) id=std::to_string(val.get<int>());
-                        else if(val.is_string()) id=val.get<std::string>();
-                    }
-                }
+    InputCounters& counters = m_inputCounters[index];
+    std::vector<PacketRef> batch;
+    batch.reserve(opts.batchSize);
+    while (m_isRunning) {
+        // Short timeout so stop() is noticed without traffic
+        int n = rx.receive(100);
+        for (int i = 0; i < n; ++i) {
+            PacketRef pkt = rx.take(i);
+            if (!pkt) continue;
+            pkt->input = uint16_t(index);
+            batch.push_back(std::move(pkt));
+        }
+        if (n > 0) {
+            counters.datagrams.store(rx.datagrams(), std::memory_order_relaxed);
+            counters.truncated.store(rx.truncated(), std::memory_order_relaxed);
+        }
+        if (!batch.empty()) enqueueIngest(batch);
+    }
 
-                if (isGeo && (id.empty() || id == "0")) {
-                    m_sensorLat = lat; m_sensorLon = lon; m_hasOrigin = true;
-                }
+    {
+        std::lock_guard<std::mutex> lock(m_rxMutex);
+        m_receivers.erase(std::remove(m_receivers.begin(), m_receivers.end(), &rx), m_receivers.end());
+    }
+    if (rx.truncated() > 0) {
+        Logger::warn("[MARS] Input '{}': {} datagrams exceeded buffer_size and were dropped", input.label, rx.truncated());
+    }
+}
+
+bool MarsEngine::applyFilter(const AsterixSelect& select) {
+    std::lock_guard<std::mutex> lock(m_rxMutex);
+    bool ok = true;
+    for (UdpReceiver* rx : m_receivers) ok = rx->setFilter(select) && ok;
+    if (m_ring) ok = m_ring->setFilter(select) && ok;
+    if (!ok) {
+        // Some sockets may already run the new program: put the old one back
+        AsterixSelect previous{m_config.active_categories, m_config.allowed_sources};
+        for (UdpReceiver* rx : m_receivers) rx->setFilter(previous);
+        if (m_ring) m_ring->setFilter(previous);
+        Logger::error("[MARS] Kernel filter rejected; the previous one stays in place");
+        return false;
+    }
+    m_config.active_categories = select.categories;
+    m_config.allowed_sources = select.sources;
+    m_selectVersion.fetch_add(1, std::memory_order_release);
+    Logger::info("[MARS] Kernel filter: {} categories, {} sources",
+                 select.categories.size(), select.sources.size());
+    return true;
+}
+
+void MarsEngine::enqueueIngest(std::vector<PacketRef>& batch) {
+    {
+        std::lock_guard<std::mutex> lock(m_ingestMutex);
+        for (auto& pkt : batch) m_ingestQueue.push_back(std::move(pkt));
+    }
+    batch.clear();
+    notifyIngest();
+}
+
+void MarsEngine::notifyIngest() {
+    m_ingestCv.notify_one();
+    int efd = m_ingestEventFd.load(std::memory_order_relaxed);
+    if (efd >= 0) {
+        uint64_t one = 1;
+        if (write(efd, &one, sizeof(one)) < 0) {}
+    }
+}
+
+// --- NATIVE DECODER ---
+void MarsEngine::runDecodeLoop() {
+    std::deque<PacketRef> batch;
+    while (m_isRunning) {
+        {
+            std::unique_lock<std::mutex> lock(m_ingestMutex);
+            // Sleeps until packets arrive or the next timer is due
+            m_ingestCv.wait_for(lock, std::chrono::milliseconds(nextTimerMs()), [this] { return !m_ingestQueue.empty(); });
+            batch.swap(m_ingestQueue);
+        }
+        for (const auto& pkt : batch) handleDatagram(pkt);
+        batch.clear();
+        serviceTimers();
+    }
+}
+
+nlohmann::json MarsEngine::mlatStatus() const {
+    double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return m_mlat.toJson(now);
+}
+
+std::vector<MarsEngine::InputStats> MarsEngine::inputStats() const {
+    std::vector<InputStats> out;
+    for (size_t i = 0; i < m_inputCounters.size() && i < m_config.inputs.size(); ++i) {
+        InputStats s;
+        s.label = m_config.inputs[i].label;
+        s.datagrams = m_inputCounters[i].datagrams.load(std::memory_order_relaxed);
+        s.truncated = m_inputCounters[i].truncated.load(std::memory_order_relaxed);
+        out.push_back(s);
+    }
+    return out;
+}
+
+bool MarsEngine::selectBlocks(const PacketRef& pkt, const uint8_t*& data, uint32_t& len) {
+    uint32_t version = m_selectVersion.load(std::memory_order_acquire);
+    if (version != m_blockSelectVersion) {
+        std::lock_guard<std::mutex> lock(m_rxMutex);
+        m_blockSelect = AsterixSelect{m_config.active_categories, m_config.allowed_sources};
+        m_blockSelectVersion = version;
+    }
+    data = pkt.payload();
+    len = pkt.payloadLen();
+    if (!m_blockSelect.empty() && m_blockSelect.keepBlocks(data, len, m_blockScratch)) {
+        data = m_blockScratch.data();
+        len = uint32_t(m_blockScratch.size());
+    }
+    return len > 0;
+}
 
-                if (m_config.send_tak_tracks && !id.empty()) {
-                    double trkLat=0, trkLon=0; 
-                    bool ready=false;
-                    if (isGeo) { trkLat=lat; trkLon=lon; ready=true; }
-                    else if (isPolar && m_hasOrigin && rho>=0) { 
-                        polarToGeo(m_sensorLat, m_sensorLon, rho, theta, trkLat, trkLon); 
-                        ready=true; 
-                    }
-                    if (ready) {
-                        std::stringstream xml;
-                        xml << "<event version='2.0' uid='GNE-TRK-" << id << "' type='a-u-G' how='m-g' time='" << getIsoTime(0) << "' start='" << getIsoTime(0) << "' stale='" << getIsoTime(5) << "'>"
-                            << "<point lat='" << trkLat << "' lon='" << trkLon << "' hae='0' ce='25' le='25'/>"
-                            << "<detail><contact callsign=" << id << "'/></detail></event>";
-                        sendToTak(xml.str());
-                    }
+void MarsEngine::handleDatagram(const PacketRef& pkt) {
+    relayAsterix(pkt.payload(), pkt.payloadLen());
+
+    const uint8_t* data;
+    uint32_t len;
+    if (!selectBlocks(pkt, data, len)) return;
+    m_decoded.clear();
+    if (!m_decoder.decode(data, len, m_decoded)) return;
+    // Video goes to the raster only; it would crowd plots out of the web feed
+    if (!m_decoded.cat240.empty()) pushVideo(pkt);
+    reportDecoded(m_decoded);
+}
+
+void MarsEngine::reportDecoded(const AsterixDecodeResult& decoded) {
+    beginCotBatch();
+    reportPlots(decoded);
+    flushCotBatch();
+}
+
+// Velocity components (m/s, x east / y north) as a CoT course and speed
+static void setVelocity(PlotReport& r, double vx, double vy) {
+    double course = atan2(vx, vy) * 180.0 / PI;
+    r.course = course < 0 ? course + 360.0 : course;
+    r.speed = std::hypot(vx, vy);
+    r.hasVelocity = true;
+}
+
+// Category, data source and time of day, common to every typed record
+template <typename Record>
+static void setSource(PlotReport& r, uint8_t category, const Record& rec, uint32_t sourceField, uint32_t timeField) {
+    r.category = category;
+    if (rec.present & sourceField) { r.sac = rec.sac; r.sic = rec.sic; r.hasSource = true; }
+    if (rec.present & timeField) r.timeOfDay = rec.timeOfDay;
+}
+
+// Comm-B registers of a Mode S target: this report's I250 applied to the
+// aircraft's cached state, else whatever earlier scans left there
+const ModeSData* MarsEngine::modeS(uint32_t address, const uint8_t* blocks, uint8_t count, double now) {
+    if (count > 0) {
+        std::lock_guard<std::mutex> lock(m_adsbMutex);
+        AdsbTable::Entry& ac = m_adsb.upsert(address, now);
+        if (decodeModeS(blocks, count, ac.modeS) > 0) ac.modeSTime = now;
+    }
+    return currentModeS(address, now);
+}
+
+// Cached registers no recent report confirmed describe an earlier state of
+// the aircraft, so they are left out (decode thread, or m_adsbMutex held)
+const ModeSData* MarsEngine::currentModeS(uint32_t address, double now) const {
+    const AdsbTable::Entry* ac = m_adsb.find(address);
+    if (!ac || !ac->modeS.present || now - ac->modeSTime > MODE_S_MAX_AGE_S) return nullptr;
+    return &ac->modeS;
+}
+
+void MarsEngine::reportPlots(const AsterixDecodeResult& decoded) {
+    double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    for (const auto& rec : decoded.cat034) {
+        PlotReport r;
+        setSource(r, 34, rec, C034_DATA_SOURCE, C034_TIME);
+        if (rec.present & C034_POSITION) { r.lat = rec.lat; r.lon = rec.lon; r.isGeo = true; }
+        handleReport(r, now);
+    }
+    for (const auto& rec : decoded.cat048) {
+        PlotReport r;
+        setSource(r, 48, rec, C048_DATA_SOURCE, C048_TIME);
+        if (rec.present & C048_TRACK_NUMBER) {
+            r.id = std::to_string(rec.trackNumber);
+            r.trackKey = TrackStore::key(TRACK_SENSOR, r.sac, r.sic, rec.trackNumber);
+        }
+        if (rec.present & C048_POLAR) { r.rho = rec.rho; r.theta = rec.theta; r.isPolar = true; }
+        if (rec.present & C048_VELOCITY) { r.course = rec.heading; r.speed = rec.groundSpeed * NM_TO_M; r.hasVelocity = true; }
+        if (rec.present & C048_FLIGHT_LEVEL) { r.flightLevel = rec.flightLevel; r.hasFlightLevel = true; }
+        if (rec.present & C048_MODE3A) { r.mode3A = rec.mode3A; r.hasMode3A = true; }
+        if (rec.present & C048_CALLSIGN) r.callsign = rec.callsign;
+        if (rec.present & C048_ADDRESS) {
+            r.address = rec.aircraftAddress; r.hasAddress = true;
+            r.modeS = modeS(rec.aircraftAddress, rec.modeS, (rec.present & C048_MODE_S) ? rec.modeSCount : 0, now);
+        }
+        handleReport(r, now);
+    }
+    // Columnar CAT048: already scaled, projected here in batches, one per
+    // run of rows from the same radar (normally the whole datagram)
+    const PlotColumns& plots = decoded.plots048;
+    if (plots.count > 0) {
+        if (m_plotLat.size() < plots.count) {
+            m_plotLat.resize(plots.count); m_plotLon.resize(plots.count); m_plotProjected.resize(plots.count);
+        }
+        auto sourceOf = [&plots](size_t i) {
+            return (plots.present[i] & C048_DATA_SOURCE) ? uint16_t(plots.sac[i] << 8 | plots.sic[i]) : uint16_t(0);
+        };
+        for (size_t i = 0, j; i < plots.count; i = j) {
+            uint16_t source = sourceOf(i);
+            for (j = i + 1; j < plots.count && sourceOf(j) == source; ++j) {}
+            const SensorOrigin* site = origin(uint8_t(source >> 8), uint8_t(source));
+            if (site) {
+                polarToGeoColumns(site->lat, site->lon, plots.rho.data() + i, plots.theta.data() + i, j - i,
+                                  m_plotLat.data() + i, m_plotLon.data() + i);
+            }
+            std::fill(m_plotProjected.begin() + i, m_plotProjected.begin() + j, site != nullptr);
+        }
+        for (size_t i = 0; i < plots.count; ++i) {
+            uint32_t present = plots.present[i];
+            PlotReport r;
+            r.category = 48;
+            if (present & C048_DATA_SOURCE) { r.sac = plots.sac[i]; r.sic = plots.sic[i]; r.hasSource = true; }
+            if (present & C048_TIME) r.timeOfDay = plots.timeOfDay[i];
+            if (present & C048_TRACK_NUMBER) {
+                r.id = std::to_string(plots.trackNumber[i]);
+                r.trackKey = TrackStore::key(TRACK_SENSOR, r.sac, r.sic, plots.trackNumber[i]);
+            }
+            if (present & C048_POLAR) {
+                r.rho = plots.rho[i]; r.theta = plots.theta[i]; r.isPolar = true;
+                if (m_plotProjected[i]) { r.lat = m_plotLat[i]; r.lon = m_plotLon[i]; r.isProjected = true; }
+            }
+            if (present & C048_VELOCITY) {
+                r.course = plots.heading[i]; r.speed = plots.groundSpeed[i] * NM_TO_M; r.hasVelocity = true;
+            }
+            if (present & C048_FLIGHT_LEVEL) { r.flightLevel = plots.flightLevel[i]; r.hasFlightLevel = true; }
+            if (present & C048_MODE3A) { r.mode3A = plots.mode3A[i]; r.hasMode3A = true; }
+            if (present & C048_CALLSIGN) r.callsign = plots.callsign[i].data();
+            if (present & C048_ADDRESS) {
+                r.address = plots.address[i]; r.hasAddress = true;
+                r.modeS = modeS(plots.address[i], plots.modeS[i], (present & C048_MODE_S) ? plots.modeSCount[i] : 0, now);
+            }
+            handleReport(r, now);
+        }
+    }
+    // System tracks: geodetic already, but otherwise tracked and fused like
+    // any other source (a CAT062 track can join a radar track in m_fused)
+    for (const auto& rec : decoded.cat062) {
+        if (!(rec.present & C062_TRACK_NUMBER) || !(rec.present & C062_POSITION)) continue;
+        PlotReport r;
+        setSource(r, 62, rec, C062_DATA_SOURCE, C062_TIME);
+        r.id = "SYS" + std::to_string(rec.trackNumber);
+        r.trackKey = TrackStore::key(TRACK_SYSTEM, r.sac, r.sic, rec.trackNumber);
+        if (rec.present & C062_IDENTIFICATION) r.callsign = rec.callsign;
+        r.lat = rec.lat; r.lon = rec.lon; r.isGeo = true;
+        if (rec.present & C062_VELOCITY) setVelocity(r, rec.vx, rec.vy);
+        if (rec.present & C062_MEASURED_FL) { r.flightLevel = rec.measuredFL; r.hasFlightLevel = true; }
+        if (rec.present & C062_MODE3A) { r.mode3A = rec.mode3A; r.hasMode3A = true; }
+        if ((rec.present & C062_DERIVED) && (rec.derived & C062_ADR)) { r.address = rec.address; r.hasAddress = true; }
+        handleReport(r, now);
+    }
+    for (const auto& rec : decoded.other) pushWeb(rec, decoded);
+    if (decoded.cat021.empty() && decoded.cat020.empty() && decoded.cat019.empty()) return;
+
+    // ADS-B: keyed by address. Identification comes in only some reports,
+    // so the last one seen is kept per aircraft.
+    for (const auto& rec : decoded.cat021) {
+        if (!(rec.present & C021_ADDRESS)) continue;
+        AdsbTable::Entry* entry;
+        {
+            std::lock_guard<std::mutex> lock(m_adsbMutex);
+            entry = &m_adsb.upsert(rec.address, now);
+            if (rec.present & C021_IDENTIFICATION) memcpy(entry->callsign, rec.callsign, sizeof(entry->callsign));
+        }
+        const AdsbTable::Entry& ac = *entry;
+        if (!(rec.present & (C021_POSITION | C021_POSITION_HR))) continue;
+
+        char addr[8];
+        snprintf(addr, sizeof(addr), "%06X", rec.address);
+        PlotReport r;
+        setSource(r, 21, rec, C021_DATA_SOURCE, C021_TIME);
+        r.id = addr;
+        r.trackKey = TrackStore::key(TRACK_ADDRESS, 0, 0, rec.address);
+        r.address = rec.address; r.hasAddress = true;
+        if (rec.present & C021_MODE3A) { r.mode3A = rec.mode3A; r.hasMode3A = true; }
+        r.callsign = ac.callsign;
+        r.lat = rec.lat; r.lon = rec.lon; r.isGeo = true;
+        if (rec.present & C021_VELOCITY) {
+            r.course = rec.trackAngle;
+            r.speed = rec.groundSpeed * NM_TO_M;
+            r.hasVelocity = true;
+        }
+        if (rec.present & C021_FLIGHT_LEVEL) { r.flightLevel = rec.flightLevel; r.hasFlightLevel = true; }
+        handleReport(r, now);
+    }
+
+    // MLAT: Mode S targets share the address table with ADS-B, so both
+    // feeds report one aircraft under one id; Mode A/C-only targets keep
+    // the system's track number
+    for (const auto& rec : decoded.cat020) {
+        if (!(rec.present & C020_POSITION)) continue;
+        PlotReport r;
+        setSource(r, 20, rec, C020_DATA_SOURCE, C020_TIME);
+        if (rec.present & C020_ADDRESS) {
+            AdsbTable::Entry* entry;
+            {
+                std::lock_guard<std::mutex> lock(m_adsbMutex);
+                entry = &m_adsb.upsert(rec.address, now);
+                if (rec.present & C020_IDENTIFICATION) memcpy(entry->callsign, rec.callsign, sizeof(entry->callsign));
+                if ((rec.present & C020_MODE_S) && decodeModeS(rec.modeS, rec.modeSCount, entry->modeS) > 0) {
+                    entry->modeSTime = now;
                 }
-            } catch (...) {}
+            }
+            const AdsbTable::Entry& ac = *entry;
+            r.modeS = currentModeS(rec.address, now);
+            char addr[8];
+            snprintf(addr, sizeof(addr), "%06X", rec.address);
+            r.id = addr;
+            r.trackKey = TrackStore::key(TRACK_ADDRESS, 0, 0, rec.address);
+            r.address = rec.address; r.hasAddress = true;
+            r.callsign = ac.callsign;
+        } else if (rec.present & C020_TRACK_NUMBER) {
+            r.id = "MLT" + std::to_string(rec.trackNumber);
+            r.trackKey = TrackStore::key(TRACK_SENSOR, r.sac, r.sic, rec.trackNumber);
         } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            continue;
         }
+        r.lat = rec.lat; r.lon = rec.lon; r.isGeo = true;
+        if (rec.present & C020_VELOCITY) setVelocity(r, rec.vx, rec.vy);
+        if (rec.present & C020_FLIGHT_LEVEL) { r.flightLevel = rec.flightLevel; r.hasFlightLevel = true; }
+        if (rec.present & C020_MODE3A) { r.mode3A = rec.mode3A; r.hasMode3A = true; }
+        handleReport(r, now);
+    }
+    for (const auto& rec : decoded.cat019) m_mlat.update(rec, now);
+}
 
-        if (m_config.send_sensor_pos && m_hasOrigin) {
-            auto now = std::chrono::steady_clock::now();
-            if (std::chrono::duration_cast<std::chrono::seconds>(now - lastOriginCoT).count() >= 10) {
-                std::stringstream xml;
-                xml << "<event version='2.0' uid='SENSOR-ORIGIN' type='a-f-G-U-H' how='m-g' time='" << getIsoTime(0) << "' start='" << getIsoTime(0) << "' stale='" << getIsoTime(20) << "'>"
-                    << "<point lat='" << m_sensorLat << "' lon='" << m_sensorLon << "' hae='0' ce='10' le='10'/>"
-                    << "<detail><contact callsign='GNE'/></detail></event>";
-                sendToTak(xml.str());
-                lastOriginCoT = now;
-            }
+// --- TSHARK FALLBACK ---
+// Output arguments for either tshark back-end ("-T ek" or the fields list)
+std::string MarsEngine::prepareTsharkOutput() {
+    AsterixConfigParser mapping;
+    bool haveMapping = mapping.loadConfig("resources/tshark_config.json");
+
+    // EK lines: keys resolve to mapping ids through the extractor's perfect
+    // hash; only the core fields handleEkLine() reads are converted
+    if (m_config.decoder_mode != "tshark-fields") {
+        if (!m_ekExtractor.compile(haveMapping ? &mapping : nullptr))
+            Logger::error("[MARS] Could not index the EK field keys");
+        return "-T ek";
+    }
+
+    // Only the mapped columns; tshark skips rendering everything else
+    m_tsharkFields.configure(haveMapping ? mapping.allMappings() : std::vector<AsterixMapping>(),
+                             TsharkFields::queryKnownFields());
+    return m_tsharkFields.tsharkArgs();
+}
+
+void MarsEngine::runTsharkPoolLoop() {
+    bool fieldsMode = (m_config.decoder_mode == "tshark-fields");
+    std::string output = prepareTsharkOutput();
+    auto dispatch = (m_config.tshark_dispatch == "sacsic") ? TsharkPool::Dispatch::SacSic
+                                                           : TsharkPool::Dispatch::RoundRobin;
+
+    TsharkPool pool;
+    // One worker is the plain fallback; it still reads our capture, never the interface
+    int workers = std::max(1, m_config.tshark_workers);
+    if (!pool.start(workers, m_config.rx_port, output, !fieldsMode, dispatch)) {
+        Logger::error("[MARS] Failed to start Tshark workers!");
+        return;
+    }
+    // Ingest producers signal this so the pipe poll below wakes for new packets
+    m_ingestEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    auto onLine = [this, fieldsMode](const char* line, size_t len) {
+        if (fieldsMode) handleFieldsLine(line, len);
+        else handleEkLine(line, len);
+    };
+
+    std::deque<PacketRef> batch;
+    while (m_isRunning) {
+        {
+            std::lock_guard<std::mutex> lock(m_ingestMutex);
+            batch.swap(m_ingestQueue);
+        }
+        for (const auto& pkt : batch) {
+            relayAsterix(pkt.payload(), pkt.payloadLen());
+            const uint8_t* data;
+            uint32_t len;
+            if (selectBlocks(pkt, data, len)) pool.submit(pkt, data, len);
         }
+        batch.clear();
+
+        pool.poll(nextTimerMs(), m_ingestEventFd, onLine);
+        serviceTimers();
+        if (!pool.anyAlive()) { Logger::error("[MARS] All Tshark workers exited."); break; }
     }
-    pclose(pipe);
-    cleanupSSL();
-    close(sockAst);
+
+    if (pool.dropped() > 0) Logger::warn("[MARS] {} packets lost to stalled Tshark workers", pool.dropped());
+    pool.stop();
+}
+
+void MarsEngine::handleEkLine(const char* line, size_t len) {
+    // One pass over the text; only registered keys are converted
+    if (!m_ekExtractor.extract(line, len, m_ekFields) || !m_ekFields.hasAsterix) return;
+
+    const EkFields& f = m_ekFields;
+    PlotReport r;
+    if (f.has(EK_CATEGORY)) r.category = uint8_t(f.get(EK_CATEGORY));
+    if (f.has(EK_SAC) && f.has(EK_SIC)) { r.sac = uint8_t(f.get(EK_SAC)); r.sic = uint8_t(f.get(EK_SIC)); r.hasSource = true; }
+    if (f.has(EK_LAT)) { r.lat = f.get(EK_LAT); r.isGeo = true; }
+    if (f.has(EK_LON)) { r.lon = f.get(EK_LON); r.isGeo = true; }
+    if (f.has(EK_RHO)) { r.rho = f.get(EK_RHO); r.isPolar = true; }
+    if (f.has(EK_THETA)) { r.theta = f.get(EK_THETA); r.isPolar = true; }
+    if (f.has(EK_TRACK_NUMBER)) {
+        uint32_t trackNumber = uint32_t(f.get(EK_TRACK_NUMBER));
+        r.id = std::to_string(trackNumber);
+        r.trackKey = TrackStore::key(TRACK_SENSOR, r.sac, r.sic, trackNumber);
+    }
+
+    handleReport(r, std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void MarsEngine::handleFieldsLine(const char* line, size_t len) {
+    m_decoded.clear();
+    if (m_tsharkFields.parse(line, len, m_decoded.cat034, m_decoded.cat048) == 0) return;
+    reportDecoded(m_decoded);
 }
 
-std::vector<nlohmann::json> MarsEngine::pollData() {
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    if (m_webQueue.empty()) return {};
-    std::vector<nlohmann::json> batch(m_webQueue.begin(), m_webQueue.end());
-    m_webQueue.clear();
-    return batch;
-}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "MlatStatus.hpp"
+#include <algorithm>
+
+bool MlatStatusTable::update(const Cat019Record& r, double now) {
+    if (!(r.present & C019_DATA_SOURCE)) return false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    System* sys = nullptr;
+    for (size_t i = 0; i < m_count; ++i) {
+        if (m_systems[i].sac == r.sac && m_systems[i].sic == r.sic) { sys = &m_systems[i]; break; }
+    }
+    if (!sys) {
+        if (m_count == MAX_SYSTEMS) return false;
+        sys = &m_systems[m_count++];
+        sys->sac = r.sac;
+        sys->sic = r.sic;
+    }
+
+    sys->lastSeen = now;
+    sys->messages++;
+    if (r.present & C019_SYSTEM_STATUS) { sys->systemStatus = r.systemStatus; sys->hasSystemStatus = true; }
+    if (r.present & C019_PROCESSOR) { sys->processorStatus = r.processorStatus; sys->hasProcessorStatus = true; }
+    if (r.present & C019_SENSORS) {
+        // Each message lists the sensors it reports on; later entries replace earlier ones
+        sys->sensorCount = uint8_t(std::min<size_t>(r.sensorCount, MAX_SENSORS));
+        for (size_t i = 0; i < sys->sensorCount; ++i) {
+            sys->sensors[i].id = r.sensors[i * 2];
+            sys->sensors[i].status = r.sensors[i * 2 + 1];
+        }
+    }
+    if (r.present & C019_REFERENCE_POINT) {
+        sys->refLat = r.refLat;
+        sys->refLon = r.refLon;
+        sys->hasReference = true;
+    }
+    if (r.present & C019_REFERENCE_HEIGHT) sys->refHeight = r.refHeight;
+    return true;
+}
+
+nlohmann::json MlatStatusTable::toJson(double now) const {
+    static const char* const STATE[] = {"operational", "degraded", "nogo", "undefined"};
+
+    nlohmann::json out = nlohmann::json::array();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_count; ++i) {
+        const System& s = m_systems[i];
+        nlohmann::json j;
+        j["sac"] = s.sac;
+        j["sic"] = s.sic;
+        j["age_s"] = now - s.lastSeen;
+        j["messages"] = s.messages;
+        if (s.hasSystemStatus) {
+            j["state"] = STATE[s.systemStatus >> 6];
+            j["overload"] = bool(s.systemStatus & 0x20);
+            j["time_source_invalid"] = bool(s.systemStatus & 0x10);
+            j["test_target_failure"] = bool(s.systemStatus & 0x08);
+        }
+        if (s.hasProcessorStatus) {
+            for (int tp = 0; tp < 4; ++tp) {
+                uint8_t bits = uint8_t(s.processorStatus >> (6 - 2 * tp));
+                j["processors"].push_back({{"exec", bool(bits & 0x02)}, {"good", bool(bits & 0x01)}});
+            }
+        }
+        j["sensors"] = nlohmann::json::array();
+        size_t good = 0;
+        for (size_t k = 0; k < s.sensorCount; ++k) {
+            uint8_t st = s.sensors[k].status;
+            bool ok = (st & 0x08) && (st & 0x04);
+            good += ok;
+            j["sensors"].push_back({{"id", s.sensors[k].id}, {"rx1090", bool(st & 0x40)}, {"tx1030", bool(st & 0x20)},
+                                    {"tx1090", bool(st & 0x10)}, {"good", bool(st & 0x08)}, {"online", bool(st & 0x04)}});
+        }
+        j["sensors_ok"] = good;
+        if (s.hasReference) {
+            j["reference"] = {{"lat", s.refLat}, {"lon", s.refLon}, {"height", s.refHeight}};
+        }
+        out.push_back(j);
+    }
+    return out;
+}
@@ -0,0 +1,220 @@
+#include "ModeS.hpp"
+#include "AdsbTable.hpp"
+#include "AsterixDecoder.hpp"
+#include "PacketRing.hpp"
+#include "PcapWriter.hpp"
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+
+// --- COMM-B REGISTERS ---
+// MB bits are numbered 1..56 from the most significant, as in ICAO Doc 9871
+static uint64_t bits(uint64_t mb, int first, int count) {
+    return (mb >> (57 - first - count)) & ((uint64_t(1) << count) - 1);
+}
+
+// Two's complement value whose sign bit is 'first'
+static int64_t signedBits(uint64_t mb, int first, int count) {
+    int64_t v = int64_t(bits(mb, first, count));
+    return (v & (int64_t(1) << (count - 1))) ? v - (int64_t(1) << count) : v;
+}
+
+// A field is its status bit followed by 'count' value bits. With the status
+// clear the value bits must be zero, which is what rejects MB fields that
+// are not really this register.
+struct MbField {
+    int status;
+    int count;
+    bool valid(uint64_t mb) const { return bits(mb, status, 1) || bits(mb, status + 1, count) == 0; }
+    bool present(uint64_t mb) const { return bits(mb, status, 1) != 0; }
+};
+
+static bool consistent(uint64_t mb, std::initializer_list<MbField> fields) {
+    for (const auto& f : fields) if (!f.valid(mb)) return false;
+    return true;
+}
+
+static void set(ModeSData& s, uint16_t flag, bool present, double& field, double value) {
+    if (present) { field = value; s.present |= flag; }
+    else s.present &= uint16_t(~flag);
+}
+
+static double wrap360(double deg) { return deg < 0 ? deg + 360.0 : deg; }
+
+// Selected vertical intention
+static bool decodeBds40(uint64_t mb, ModeSData& s) {
+    const MbField mcp{1, 12}, fms{14, 12}, baro{27, 12};
+    if (!consistent(mb, {mcp, fms, baro}) || bits(mb, 40, 8) != 0 || bits(mb, 52, 2) != 0) return false;
+    set(s, MS_SELECTED_ALTITUDE, mcp.present(mb), s.selectedAltitude, bits(mb, 2, 12) * 16.0);
+    set(s, MS_FMS_ALTITUDE, fms.present(mb), s.fmsAltitude, bits(mb, 15, 12) * 16.0);
+    set(s, MS_BARO_SETTING, baro.present(mb), s.baroSetting, 800.0 + bits(mb, 28, 12) * 0.1);
+    return true;
+}
+
+// Track and turn report
+static bool decodeBds50(uint64_t mb, ModeSData& s) {
+    const MbField roll{1, 10}, track{12, 11}, gs{24, 10}, rate{35, 10}, tas{46, 10};
+    if (!consistent(mb, {roll, track, gs, rate, tas})) return false;
+    double rollDeg = signedBits(mb, 2, 10) * (45.0 / 256.0);
+    if (roll.present(mb) && (rollDeg < -90.0 || rollDeg > 90.0)) return false;
+    set(s, MS_ROLL, roll.present(mb), s.roll, rollDeg);
+    set(s, MS_TRUE_TRACK, track.present(mb), s.trueTrack, wrap360(signedBits(mb, 13, 11) * (90.0 / 512.0)));
+    set(s, MS_GROUND_SPEED, gs.present(mb), s.groundSpeed, bits(mb, 25, 10) * 2.0);
+    set(s, MS_TRACK_RATE, rate.present(mb), s.trackRate, signedBits(mb, 36, 10) * (8.0 / 256.0));
+    set(s, MS_TRUE_AIRSPEED, tas.present(mb), s.trueAirspeed, bits(mb, 47, 10) * 2.0);
+    return true;
+}
+
+// Heading and speed report
+static bool decodeBds60(uint64_t mb, ModeSData& s) {
+    const MbField hdg{1, 11}, ias{13, 10}, mach{24, 10}, baro{35, 10}, ivv{46, 10};
+    if (!consistent(mb, {hdg, ias, mach, baro, ivv})) return false;
+    set(s, MS_MAG_HEADING, hdg.present(mb), s.magHeading, wrap360(signedBits(mb, 2, 11) * (90.0 / 512.0)));
+    set(s, MS_IAS, ias.present(mb), s.ias, double(bits(mb, 14, 10)));
+    set(s, MS_MACH, mach.present(mb), s.mach, bits(mb, 25, 10) * (2.048 / 512.0));
+    set(s, MS_BARO_RATE, baro.present(mb), s.baroRate, signedBits(mb, 36, 10) * 32.0);
+    set(s, MS_INERTIAL_RATE, ivv.present(mb), s.inertialRate, signedBits(mb, 47, 10) * 32.0);
+    return true;
+}
+
+int decodeModeS(const uint8_t* blocks, size_t count, ModeSData& state) {
+    int current = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* p = blocks + i * 8;
+        int reg;
+        switch (p[7]) {
+            case 0x40: reg = 0; break;
+            case 0x50: reg = 1; break;
+            case 0x60: reg = 2; break;
+            default: continue;
+        }
+        uint64_t mb = 0;
+        for (int k = 0; k < 7; ++k) mb = (mb << 8) | p[k];
+        // Same register content as last scan: still current, nothing to decode
+        if (mb == state.lastMb[reg]) { current += (mb != 0); continue; }
+
+        bool ok = (reg == 0) ? decodeBds40(mb, state) : (reg == 1) ? decodeBds50(mb, state) : decodeBds60(mb, state);
+        if (ok) { state.lastMb[reg] = mb; ++current; }
+    }
+    return current;
+}
+
+const ModeSValue MODE_S_VALUES[MODE_S_VALUE_COUNT] = {
+    {MS_SELECTED_ALTITUDE, &ModeSData::selectedAltitude, "selected_altitude_ft", "%.0f"},
+    {MS_FMS_ALTITUDE,      &ModeSData::fmsAltitude,      "fms_altitude_ft",      "%.0f"},
+    {MS_BARO_SETTING,      &ModeSData::baroSetting,      "baro_setting_hpa",     "%.1f"},
+    {MS_ROLL,              &ModeSData::roll,             "roll_deg",             "%.2f"},
+    {MS_TRUE_TRACK,        &ModeSData::trueTrack,        "true_track_deg",       "%.2f"},
+    {MS_GROUND_SPEED,      &ModeSData::groundSpeed,      "ground_speed_kt",      "%.0f"},
+    {MS_TRACK_RATE,        &ModeSData::trackRate,        "track_rate_dps",       "%.3f"},
+    {MS_TRUE_AIRSPEED,     &ModeSData::trueAirspeed,     "true_airspeed_kt",     "%.0f"},
+    {MS_MAG_HEADING,       &ModeSData::magHeading,       "magnetic_heading_deg", "%.2f"},
+    {MS_IAS,               &ModeSData::ias,              "ias_kt",               "%.0f"},
+    {MS_MACH,              &ModeSData::mach,             "mach",                 "%.3f"},
+    {MS_BARO_RATE,         &ModeSData::baroRate,         "baro_rate_fpm",        "%.0f"},
+    {MS_INERTIAL_RATE,     &ModeSData::inertialRate,     "inertial_rate_fpm",    "%.0f"},
+};
+
+// --- EXPORT ---
+// Classic pcap, either timestamp resolution, either byte order
+struct PcapFile {
+    FILE* f = nullptr;
+    bool swapped = false;
+    int linkHeaderLen = -1;
+
+    uint32_t u32(const uint8_t* p) const {
+        uint32_t v = uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+        return swapped ? __builtin_bswap32(v) : v;
+    }
+
+    bool open(const std::string& path) {
+        f = fopen(path.c_str(), "rb");
+        uint8_t hdr[24];
+        if (!f || fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr)) return false;
+        uint32_t magic = u32(hdr);
+        if (magic == 0xD4C3B2A1 || magic == 0x4D3CB2A1) { swapped = true; magic = u32(hdr); }
+        if (magic != 0xA1B2C3D4 && magic != 0xA1B23C4D) return false;
+        switch (u32(hdr + 20)) {
+            case PcapWriter::LINKTYPE_ETHERNET: linkHeaderLen = 14; break;
+            case PcapWriter::LINKTYPE_RAW: linkHeaderLen = 0; break;
+            case 113: linkHeaderLen = 16; break;   // Linux cooked capture
+            default: return false;
+        }
+        return true;
+    }
+
+    bool next(std::vector<uint8_t>& frame) {
+        uint8_t rec[16];
+        if (fread(rec, 1, sizeof(rec), f) != sizeof(rec)) return false;
+        uint32_t capLen = u32(rec + 8);
+        if (capLen > (1u << 24)) return false;
+        frame.resize(capLen);
+        return fread(frame.data(), 1, capLen, f) == capLen;
+    }
+
+    ~PcapFile() { if (f) fclose(f); }
+};
+
+static void writeRow(FILE* out, uint8_t cat, bool hasSource, uint8_t sac, uint8_t sic, double tod,
+                     uint32_t address, int trackNumber, const ModeSData& s) {
+    fprintf(out, "%u,", unsigned(cat));
+    if (hasSource) fprintf(out, "%u,%u,", unsigned(sac), unsigned(sic));
+    else fputs(",,", out);
+    if (tod >= 0) fprintf(out, "%.3f,", tod);
+    else fputc(',', out);
+    fprintf(out, "%06X,", address);
+    if (trackNumber >= 0) fprintf(out, "%d", trackNumber);
+
+    for (const auto& v : MODE_S_VALUES) {
+        fputc(',', out);
+        if (s.present & v.flag) fprintf(out, v.format, s.*v.value);
+    }
+    fputc('\n', out);
+}
+
+bool exportModeSCsv(const std::string& pcapPath, const std::string& csvPath) {
+    PcapFile in;
+    if (!in.open(pcapPath)) return false;
+    FILE* out = fopen(csvPath.c_str(), "w");
+    if (!out) return false;
+    fputs("category,sac,sic,time_of_day,address,track_number", out);
+    for (const auto& v : MODE_S_VALUES) fprintf(out, ",%s", v.name);
+    fputc('\n', out);
+
+    // Only the items that pick rows are parsed up front; the rest of a row
+    // is completed from the located items once it is known to be written
+    AsterixDecoder decoder;
+    decoder.addProjection({"export", C048_ADDRESS | C048_MODE_S, 0, 0, 0, 0, C020_ADDRESS | C020_MODE_S, 0});
+    const uint32_t rest048 = C048_DATA_SOURCE | C048_TIME | C048_TRACK_NUMBER;
+    const uint32_t rest020 = C020_DATA_SOURCE | C020_TIME | C020_TRACK_NUMBER;
+    AsterixDecodeResult decoded;
+    AdsbTable aircraft;
+    std::vector<uint8_t> frame;
+    while (in.next(frame)) {
+        const uint8_t* payload;
+        uint32_t len;
+        if (!PacketRing::udpPayload(frame.data(), uint32_t(frame.size()), in.linkHeaderLen, payload, len)) continue;
+        decoded.clear();
+        if (!decoder.decode(payload, len, decoded)) continue;
+
+        for (auto& rec : decoded.cat048) {
+            if (!(rec.present & C048_ADDRESS) || !(rec.present & C048_MODE_S)) continue;
+            AsterixDecoder::complete(rec, rest048);
+            ModeSData& s = aircraft.upsert(rec.aircraftAddress, 0).modeS;
+            decodeModeS(rec.modeS, rec.modeSCount, s);
+            writeRow(out, 48, rec.present & C048_DATA_SOURCE, rec.sac, rec.sic,
+                     (rec.present & C048_TIME) ? rec.timeOfDay : -1, rec.aircraftAddress,
+                     (rec.present & C048_TRACK_NUMBER) ? rec.trackNumber : -1, s);
+        }
+        for (auto& rec : decoded.cat020) {
+            if (!(rec.present & C020_ADDRESS) || !(rec.present & C020_MODE_S)) continue;
+            AsterixDecoder::complete(rec, rest020);
+            ModeSData& s = aircraft.upsert(rec.address, 0).modeS;
+            decodeModeS(rec.modeS, rec.modeSCount, s);
+            writeRow(out, 20, rec.present & C020_DATA_SOURCE, rec.sac, rec.sic,
+                     (rec.present & C020_TIME) ? rec.timeOfDay : -1, rec.address,
+                     (rec.present & C020_TRACK_NUMBER) ? rec.trackNumber : -1, s);
+        }
+    }
+    return fclose(out) == 0;
+}
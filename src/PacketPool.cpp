@@ -0,0 +1,49 @@
+#include "PacketPool.hpp"
+
+PacketPool::PacketPool(size_t count, uint32_t bufferSize)
+    : m_bufferSize(bufferSize), m_slab(count * bufferSize), m_buffers(count) {
+    m_free.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        PacketBuffer& b = m_buffers[i];
+        b.pool = this;
+        b.data = m_slab.data() + i * bufferSize;
+        b.capacity = bufferSize;
+        m_free.push_back(&b);
+    }
+}
+
+PacketRef PacketPool::acquire() {
+    PacketBuffer* buf = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_free.empty()) { m_exhausted++; return PacketRef(); }
+        buf = m_free.back();
+        m_free.pop_back();
+        size_t inUse = m_buffers.size() - m_free.size();
+        if (inUse > m_highWater) m_highWater = inUse;
+    }
+
+    buf->refs.store(1, std::memory_order_relaxed);
+    buf->len = buf->origLen = 0;
+    buf->payloadOff = buf->payloadLen = 0;
+    buf->tsSec = buf->tsNsec = 0;
+    buf->outgoing = false;
+    buf->input = 0;
+    return PacketRef(buf);
+}
+
+void PacketPool::release(PacketBuffer* buf) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(buf);
+}
+
+PacketPool::Stats PacketPool::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats s;
+    s.capacity = m_buffers.size();
+    s.inUse = m_buffers.size() - m_free.size();
+    s.highWater = m_highWater;
+    s.exhausted = m_exhausted;
+    s.bufferSize = m_bufferSize;
+    return s;
+}
@@ -0,0 +1,294 @@
+#include "PacketRing.hpp"
+#include "PcapWriter.hpp"
+#include "BpfFilter.hpp"
+#include "Logger.hpp"
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+#include <net/if_arp.h>
+#include <net/if.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <algorithm>
+
+PacketRing::PacketRing(AppConfig& config, PacketPool& pool) : m_config(config), m_pool(pool) {}
+
+PacketRing::~PacketRing() {
+    stop();
+    if (m_map) { munmap(m_map, m_mapLen); m_map = nullptr; }
+    if (m_fd != -1) { close(m_fd); m_fd = -1; }
+    if (m_joinFd != -1) { close(m_joinFd); m_joinFd = -1; }
+}
+
+bool PacketRing::open() {
+    // Ethernet-like interfaces keep their link header (so recordings match
+    // dumpcap's); "any" and point-to-point links use cooked frames.
+    int ifindex = 0;
+    bool ethernet = false;
+    if (!m_config.interface.empty() && m_config.interface != "any") {
+        ifindex = if_nametoindex(m_config.interface.c_str());
+        if (ifindex == 0) {
+            Logger::error("[RING] Unknown interface '{}'", m_config.interface);
+            return false;
+        }
+        int probe = socket(AF_INET, SOCK_DGRAM, 0);
+        struct ifreq ifr;
+        memset(&ifr, 0, sizeof(ifr));
+        strncpy(ifr.ifr_name, m_config.interface.c_str(), IFNAMSIZ - 1);
+        if (probe >= 0 && ioctl(probe, SIOCGIFHWADDR, &ifr) == 0) {
+            ethernet = (ifr.ifr_hwaddr.sa_family == ARPHRD_ETHER || ifr.ifr_hwaddr.sa_family == ARPHRD_LOOPBACK);
+        }
+        if (probe >= 0) close(probe);
+    }
+    m_linkHeaderLen = ethernet ? 14 : 0;
+    m_linkType = ethernet ? PcapWriter::LINKTYPE_ETHERNET : PcapWriter::LINKTYPE_RAW;
+
+    m_fd = socket(AF_PACKET, ethernet ? SOCK_RAW : SOCK_DGRAM, htons(ETH_P_ALL));
+    if (m_fd < 0) {
+        Logger::error("[RING] AF_PACKET socket failed: {} (needs CAP_NET_RAW)", strerror(errno));
+        return false;
+    }
+
+    // Record every input that arrives on this interface
+    m_ports.assign(1, m_config.rx_port);
+    for (const auto& in : m_config.inputs) {
+        bool here = (m_config.interface == "any" || in.interface == m_config.interface);
+        if (here && std::find(m_ports.begin(), m_ports.end(), in.port) == m_ports.end()) m_ports.push_back(in.port);
+    }
+
+    // Filter before bind so nothing unfiltered is ever queued
+    if (!setFilter(AsterixSelect{m_config.active_categories, m_config.allowed_sources})) {
+        close(m_fd); m_fd = -1;
+        return false;
+    }
+
+    int version = TPACKET_V3;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        Logger::error("[RING] TPACKET_V3 not supported: {}", strerror(errno));
+        close(m_fd); m_fd = -1;
+        return false;
+    }
+
+    m_blockSize = uint32_t(m_config.ring_block_size);
+    m_blockCount = uint32_t(m_config.ring_block_count);
+    const uint32_t frameSize = 2048;
+
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = m_blockSize;
+    req.tp_block_nr = m_blockCount;
+    req.tp_frame_size = frameSize;
+    req.tp_frame_nr = (m_blockSize * m_blockCount) / frameSize;
+    req.tp_retire_blk_tov = 10; // ms: hand partially filled blocks to us promptly
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        Logger::error("[RING] PACKET_RX_RING failed: {}", strerror(errno));
+        close(m_fd); m_fd = -1;
+        return false;
+    }
+
+    m_mapLen = size_t(m_blockSize) * m_blockCount;
+    void* map = mmap(nullptr, m_mapLen, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED) {
+        Logger::error("[RING] mmap failed: {}", strerror(errno));
+        close(m_fd); m_fd = -1;
+        return false;
+    }
+    m_map = static_cast<uint8_t*>(map);
+
+    struct sockaddr_ll ll;
+    memset(&ll, 0, sizeof(ll));
+    ll.sll_family = AF_PACKET;
+    ll.sll_protocol = htons(ETH_P_ALL);
+    ll.sll_ifindex = ifindex;
+    if (bind(m_fd, (struct sockaddr*)&ll, sizeof(ll)) < 0) {
+        Logger::error("[RING] bind to {} failed: {}", m_config.interface, strerror(errno));
+        munmap(m_map, m_mapLen); m_map = nullptr;
+        close(m_fd); m_fd = -1;
+        return false;
+    }
+
+    joinInterface(ifindex);
+
+    std::string portList;
+    for (int port : m_ports) portList += (portList.empty() ? "" : ",") + std::to_string(port);
+    Logger::info("[RING] Capturing '{}' udp port {} ({} x {} KB blocks)",
+                 m_config.interface, portList, m_blockCount, m_blockSize / 1024);
+    return true;
+}
+
+// The ring replaces dumpcap/tshark, which captured promiscuously, and the
+// receive sockets, which joined the multicast groups: without both the NIC
+// would drop mirrored and multicast frames before they reach the ring.
+void PacketRing::joinInterface(int ifindex) {
+    if (m_config.promiscuous && ifindex != 0) {
+        struct packet_mreq mr;
+        memset(&mr, 0, sizeof(mr));
+        mr.mr_ifindex = ifindex;
+        mr.mr_type = PACKET_MR_PROMISC;
+        if (setsockopt(m_fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mr, sizeof(mr)) < 0) {
+            Logger::warn("[RING] Promiscuous mode on {} failed: {}", m_config.interface, strerror(errno));
+        }
+    }
+
+    // A packet socket takes no IP memberships, so a plain UDP socket holds them
+    for (const auto& in : m_config.inputs) {
+        bool here = (m_config.interface == "any" || in.interface == m_config.interface);
+        struct in_addr group;
+        if (!here || in.group.empty() || inet_pton(AF_INET, in.group.c_str(), &group) != 1 ||
+            !IN_MULTICAST(ntohl(group.s_addr))) continue;
+        if (m_joinFd == -1) m_joinFd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (m_joinFd < 0) { m_joinFd = -1; break; }
+
+        struct ip_mreqn mreq;
+        memset(&mreq, 0, sizeof(mreq));
+        mreq.imr_multiaddr = group;
+        mreq.imr_address.s_addr = htonl(INADDR_ANY);
+        if (!in.interface.empty() && in.interface != "any") mreq.imr_ifindex = if_nametoindex(in.interface.c_str());
+        if (setsockopt(m_joinFd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0 && errno != EADDRINUSE) {
+            Logger::error("[RING] Failed to join {} on {}: {}", in.group, in.interface, strerror(errno));
+        } else {
+            Logger::info("[RING] Joined multicast group {} on {}", in.group, in.interface);
+        }
+    }
+}
+
+bool PacketRing::setFilter(const AsterixSelect& select) {
+    if (m_fd == -1) return false;
+    return BpfFilter::attach(m_fd, BpfFilter::udpPorts(m_ports, m_linkHeaderLen, select));
+}
+
+void PacketRing::start() {
+    if (m_fd == -1 || m_isRunning) return;
+    m_isRunning = true;
+    m_thread = std::thread(&PacketRing::captureLoop, this);
+}
+
+void PacketRing::stop() {
+    m_isRunning = false;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+int PacketRing::addSink(Sink sink) {
+    std::lock_guard<std::mutex> lock(m_sinkMutex);
+    int id = m_nextSinkId++;
+    m_sinks.emplace_back(id, std::move(sink));
+    return id;
+}
+
+void PacketRing::removeSink(int id) {
+    // Blocks while a block is being dispatched, so the sink is never called after this returns
+    std::lock_guard<std::mutex> lock(m_sinkMutex);
+    for (auto it = m_sinks.begin(); it != m_sinks.end(); ++it) {
+        if (it->first == id) { m_sinks.erase(it); break; }
+    }
+}
+
+bool PacketRing::udpPayload(const uint8_t* frame, uint32_t capLen, int linkHeaderLen,
+                            const uint8_t*& payload, uint32_t& payloadLen) {
+    uint32_t off = linkHeaderLen;
+    if (linkHeaderLen == 14) {
+        if (capLen < 14) return false;
+        uint16_t etherType = (frame[12] << 8) | frame[13];
+        if (etherType == 0x8100) {
+            // VLAN tag left in the frame (no hardware offload)
+            if (capLen < 18) return false;
+            etherType = (frame[16] << 8) | frame[17];
+            off = 18;
+        }
+        if (etherType != 0x0800) return false;
+    }
+
+    if (capLen < off + 20) return false;
+    const uint8_t* ip = frame + off;
+    if ((ip[0] >> 4) != 4 || ip[9] != 17) return false;
+    uint32_t ihl = (ip[0] & 0x0F) * 4;
+    if (ihl < 20 || capLen < off + ihl + 8) return false;
+
+    const uint8_t* udp = ip + ihl;
+    uint32_t udpLen = (udp[4] << 8) | udp[5];
+    if (udpLen < 8) return false;
+
+    payload = udp + 8;
+    payloadLen = udpLen - 8;
+    uint32_t avail = capLen - (off + ihl + 8);
+    if (payloadLen > avail) payloadLen = avail;
+    return true;
+}
+
+void PacketRing::dispatchBlock(uint8_t* block) {
+    auto* desc = reinterpret_cast<tpacket_block_desc*>(block);
+    uint32_t count = desc->hdr.bh1.num_pkts;
+    auto* pkt = reinterpret_cast<tpacket3_hdr*>(block + desc->hdr.bh1.offset_to_first_pkt);
+
+    std::lock_guard<std::mutex> lock(m_sinkMutex);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint8_t* frame = reinterpret_cast<const uint8_t*>(pkt) + pkt->tp_mac;
+        auto* ll = reinterpret_cast<const sockaddr_ll*>(reinterpret_cast<const uint8_t*>(pkt) + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+        PacketRef ref = m_sinks.empty() ? PacketRef() : m_pool.acquire();
+
+        if (ref) {
+            PacketBuffer& b = *ref;
+            b.len = pkt->tp_snaplen < b.capacity ? pkt->tp_snaplen : b.capacity;
+            b.origLen = pkt->tp_len;
+            b.tsSec = pkt->tp_sec;
+            b.tsNsec = pkt->tp_nsec;
+            b.outgoing = (ll->sll_pkttype == PACKET_OUTGOING);
+            memcpy(b.data, frame, b.len);
+
+            const uint8_t* payload = nullptr;
+            uint32_t payloadLen = 0;
+            if (udpPayload(b.data, b.len, m_linkHeaderLen, payload, payloadLen)) {
+                b.payloadOff = uint32_t(payload - b.data);
+                b.payloadLen = payloadLen;
+            }
+
+            for (auto& [id, sink] : m_sinks) sink(ref);
+        } else if (!m_sinks.empty()) {
+            m_poolDrops++;
+        }
+
+        pkt = reinterpret_cast<tpacket3_hdr*>(reinterpret_cast<uint8_t*>(pkt) + pkt->tp_next_offset);
+    }
+    m_packets += count;
+}
+
+void PacketRing::readStats() {
+    struct tpacket_stats_v3 st;
+    socklen_t len = sizeof(st);
+    if (getsockopt(m_fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) == 0 && st.tp_drops > 0) {
+        m_drops += st.tp_drops;
+        Logger::warn("[RING] Kernel dropped {} packets (ring full). Consider larger ring_block_count.", st.tp_drops);
+    }
+}
+
+void PacketRing::captureLoop() {
+    uint32_t current = 0;
+    auto lastStats = std::chrono::steady_clock::now();
+
+    while (m_isRunning) {
+        uint8_t* block = m_map + size_t(current) * m_blockSize;
+        auto* desc = reinterpret_cast<tpacket_block_desc*>(block);
+
+        if (!(__atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+            struct pollfd pfd = {m_fd, POLLIN | POLLERR, 0};
+            poll(&pfd, 1, 100);
+        } else {
+            dispatchBlock(block);
+            // Hand the block back to the kernel
+            __atomic_store_n(&desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+            current = (current + 1) % m_blockCount;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastStats > std::chrono::seconds(10)) {
+            readStats();
+            lastStats = now;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#include "PcapWriter.hpp"
+#include "Logger.hpp"
+
+namespace {
+struct PcapFileHeader {
+    uint32_t magic;
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    int32_t thisZone;
+    uint32_t sigFigs;
+    uint32_t snapLen;
+    uint32_t linkType;
+};
+
+struct PcapRecordHeader {
+    uint32_t tsSec;
+    uint32_t tsFrac;
+    uint32_t capLen;
+    uint32_t origLen;
+};
+}
+
+PcapWriter::~PcapWriter() { close(); }
+
+bool PcapWriter::open(const std::string& path, uint32_t linkType, uint32_t snapLen) {
+    close();
+    m_file = fopen(path.c_str(), "wb");
+    if (!m_file) {
+        Logger::error("[PCAP] Could not create {}", path);
+        return false;
+    }
+    // Large stdio buffer: records are small and arrive in bursts
+    setvbuf(m_file, nullptr, _IOFBF, 1 << 20);
+
+    PcapFileHeader hdr = {0xA1B23C4D, 2, 4, 0, 0, snapLen, linkType}; // Nanosecond magic
+    fwrite(&hdr, sizeof(hdr), 1, m_file);
+    return true;
+}
+
+void PcapWriter::close() {
+    if (m_file) { fclose(m_file); m_file = nullptr; }
+}
+
+void PcapWriter::write(uint32_t tsSec, uint32_t tsNsec, const uint8_t* data, uint32_t capLen, uint32_t origLen) {
+    if (!m_file) return;
+    PcapRecordHeader rec = {tsSec, tsNsec, capLen, origLen};
+    fwrite(&rec, sizeof(rec), 1, m_file);
+    fwrite(data, 1, capLen, m_file);
+}
+
+void PcapWriter::flush() {
+    if (m_file) fflush(m_file);
+}
+
+void PcapWriter::appendFileHeader(std::string& out, uint32_t linkType, uint32_t snapLen) {
+    PcapFileHeader hdr = {0xA1B23C4D, 2, 4, 0, 0, snapLen, linkType};
+    out.append(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+}
+
+void PcapWriter::appendRecord(std::string& out, uint32_t tsSec, uint32_t tsNsec,
+                              const uint8_t* data, uint32_t capLen, uint32_t origLen) {
+    PcapRecordHeader rec = {tsSec, tsNsec, capLen, origLen};
+    out.append(reinterpret_cast<const char*>(&rec), sizeof(rec));
+    out.append(reinterpret_cast<const char*>(data), capLen);
+}
@@ -0,0 +1,70 @@
+#include "PerfectHash.hpp"
+#include <algorithm>
+
+bool PerfectHash::build(const std::vector<std::string_view>& keys) {
+    m_disp.clear();
+    m_slots.clear();
+    size_t n = keys.size();
+    if (n == 0) return true;
+
+    size_t buckets = std::max<size_t>(1, (n + 1) / 2);
+    std::vector<uint64_t> hashes(n);
+    std::vector<std::vector<uint32_t>> members(buckets);
+    std::vector<uint32_t> order(buckets);
+    std::vector<uint64_t> slotHash;
+    std::vector<int32_t> slotIndex;
+    std::vector<uint64_t> placed;
+
+    for (uint64_t seed = 1; seed <= 64; ++seed) {
+        for (size_t i = 0; i < n; ++i) hashes[i] = hash(keys[i], seed);
+        // Two keys with one 64-bit hash would be indistinguishable: new seed
+        std::vector<uint64_t> sorted(hashes);
+        std::sort(sorted.begin(), sorted.end());
+        if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) continue;
+
+        for (auto& m : members) m.clear();
+        for (size_t i = 0; i < n; ++i) members[(hashes[i] >> 32) % buckets].push_back(uint32_t(i));
+        for (size_t b = 0; b < buckets; ++b) order[b] = uint32_t(b);
+        // Largest buckets first, while most slots are still free
+        std::sort(order.begin(), order.end(),
+                  [&](uint32_t a, uint32_t b) { return members[a].size() > members[b].size(); });
+
+        std::vector<uint64_t> disp(buckets, 0);
+        slotHash.assign(n, 0);
+        slotIndex.assign(n, -1);
+        bool ok = true;
+        for (uint32_t b : order) {
+            const auto& keysInBucket = members[b];
+            if (keysInBucket.empty()) break;
+            bool fits = false;
+            for (uint64_t trial = 0; trial < (1u << 16) && !fits; ++trial) {
+                uint64_t d = mix(trial * 0x9e3779b97f4a7c15ull + seed);
+                placed.clear();
+                fits = true;
+                for (uint32_t k : keysInBucket) {
+                    uint64_t slot = mix(hashes[k] ^ d) % n;
+                    if (slotIndex[slot] >= 0 || std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+                        fits = false;
+                        break;
+                    }
+                    placed.push_back(slot);
+                }
+                if (!fits) continue;
+                disp[b] = d;
+                for (size_t j = 0; j < keysInBucket.size(); ++j) {
+                    slotHash[placed[j]] = hashes[keysInBucket[j]];
+                    slotIndex[placed[j]] = int32_t(keysInBucket[j]);
+                }
+            }
+            if (!fits) { ok = false; break; }
+        }
+        if (!ok) continue;
+
+        m_seed = seed;
+        m_disp = std::move(disp);
+        m_slots.resize(n);
+        for (size_t s = 0; s < n; ++s) m_slots[s] = {slotHash[s], slotIndex[s]};
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,117 @@
+#include "PipeReader.hpp"
+#include "Logger.hpp"
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+
+PipeReader::~PipeReader() { close(); }
+
+bool PipeReader::open(const std::string& cmd) {
+    close();
+    m_pipe = popen(cmd.c_str(), "r");
+    if (!m_pipe) {
+        Logger::error("[PIPE] Failed to start: {}", cmd);
+        return false;
+    }
+
+    // Read the descriptor directly; stdio buffering is bypassed entirely
+    return attach(fileno(m_pipe));
+}
+
+bool PipeReader::attach(int fd) {
+    if (fd < 0) return false;
+    m_fd = fd;
+    int flags = fcntl(m_fd, F_GETFL, 0);
+    fcntl(m_fd, F_SETFL, flags | O_NONBLOCK);
+
+    m_buf.resize(64 * 1024);
+    m_used = m_scanned = 0;
+    m_discarding = false;
+    return true;
+}
+
+void PipeReader::close() {
+    if (m_pipe) { pclose(m_pipe); m_pipe = nullptr; }
+    else if (m_fd != -1) ::close(m_fd);
+    m_fd = -1;
+}
+
+int PipeReader::read(int timeoutMs, const LineHandler& onLine) {
+    if (m_fd == -1) return -1;
+
+    struct pollfd pfd = {m_fd, POLLIN, 0};
+    int pr = poll(&pfd, 1, timeoutMs);
+    if (pr < 0) return (errno == EINTR) ? 0 : -1;
+    if (pr == 0) return 0;
+
+    // Bounded, so a child that never pauses cannot starve the caller's
+    // timers: whatever is left is still readable on the next call
+    int delivered = 0;
+    for (int reads = 0; reads < MAX_READS; ++reads) {
+        // Keep at least half the buffer free so one read() can take a burst
+        if (m_buf.size() - m_used < m_buf.size() / 2) m_buf.resize(m_buf.size() * 2);
+
+        ssize_t n = ::read(m_fd, m_buf.data() + m_used, m_buf.size() - m_used);
+        if (n > 0) {
+            m_used += size_t(n);
+            delivered += frame(onLine);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n < 0 && errno == EINTR) continue;
+
+        // EOF (or error): flush a final unterminated line
+        if (m_used > 0 && !m_discarding) {
+            onLine(m_buf.data(), m_used);
+            m_lines++;
+            delivered++;
+        }
+        m_used = m_scanned = 0;
+        return delivered > 0 ? delivered : -1;
+    }
+    return delivered;
+}
+
+int PipeReader::frame(const LineHandler& onLine) {
+    int delivered = 0;
+    size_t start = 0;
+
+    while (true) {
+        const char* nl = static_cast<const char*>(memchr(m_buf.data() + m_scanned, '\n', m_used - m_scanned));
+        if (!nl) break;
+
+        size_t end = size_t(nl - m_buf.data());
+        if (m_discarding) {
+            m_discarding = false;     // Tail of an oversized line
+        } else {
+            size_t len = end - start;
+            if (len > 0 && m_buf[start + len - 1] == '\r') len--;
+            if (len > 0) {
+                onLine(m_buf.data() + start, len);
+                m_lines++;
+                delivered++;
+            }
+        }
+        start = m_scanned = end + 1;
+    }
+
+    // Move the partial line to the front for the next read
+    if (start > 0) {
+        memmove(m_buf.data(), m_buf.data() + start, m_used - start);
+        m_used -= start;
+    }
+    m_scanned = m_used;
+
+    if (m_used > MAX_LINE) {
+        if (!m_discarding) {
+            m_oversized++;
+            Logger::warn("[PIPE] Line exceeded {} bytes, discarded", MAX_LINE);
+        }
+        m_discarding = true;
+        m_used = m_scanned = 0;
+        if (m_buf.size() > 64 * 1024) m_buf.resize(64 * 1024);
+    }
+    return delivered;
+}
@@ -0,0 +1,88 @@
+#include "AsterixDecoder.hpp"
+#include "SimdLevel.hpp"
+#include <algorithm>
+
+// --- CONVERSION KERNELS ---
+// out[i] = in[i] * scale over a whole column
+using ScaleKernel = void (*)(const int32_t* in, double* out, size_t n, double scale);
+
+static void scaleScalar(const int32_t* in, double* out, size_t n, double scale) {
+    for (size_t i = 0; i < n; ++i) out[i] = in[i] * scale;
+}
+
+#ifdef SIMD_X86
+__attribute__((target("sse2")))
+static void scaleSse2(const int32_t* in, double* out, size_t n, double scale) {
+    const __m128d k = _mm_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_pd(out + i, _mm_mul_pd(_mm_cvtepi32_pd(v), k));
+        _mm_storeu_pd(out + i + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(v, 8)), k));
+    }
+    for (; i < n; ++i) out[i] = in[i] * scale;
+}
+
+__attribute__((target("avx2")))
+static void scaleAvx2(const int32_t* in, double* out, size_t n, double scale) {
+    const __m256d k = _mm256_set1_pd(scale);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(v)), k));
+        _mm256_storeu_pd(out + i + 4, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)), k));
+    }
+    for (; i < n; ++i) out[i] = in[i] * scale;
+}
+#endif
+
+static ScaleKernel scaleKernel() {
+#ifdef SIMD_X86
+    return simdKernel<ScaleKernel>(scaleScalar, scaleSse2, scaleAvx2);
+#else
+    return simdKernel<ScaleKernel>(scaleScalar);
+#endif
+}
+
+// --- COLUMNS ---
+void PlotColumns::grow() {
+    size_t n = present.empty() ? 64 : present.size() * 2;
+    present.resize(n);
+    sac.resize(n);
+    sic.resize(n);
+    trackNumber.resize(n);
+    mode3A.resize(n);
+    address.resize(n);
+    callsign.resize(n);
+    modeS.resize(n);
+    modeSCount.resize(n);
+    rawTime.resize(n);
+    rawRho.resize(n);
+    rawTheta.resize(n);
+    rawFlightLevel.resize(n);
+    rawSpeed.resize(n);
+    rawHeading.resize(n);
+    timeOfDay.resize(n);
+    rho.resize(n);
+    theta.resize(n);
+    flightLevel.resize(n);
+    groundSpeed.resize(n);
+    heading.resize(n);
+    lazy.resize(n);
+}
+
+void PlotColumns::convert(size_t from, size_t to) {
+    to = std::min(to, count);
+    if (from >= to) return;
+    size_t n = to - from;
+    ScaleKernel scale = scaleKernel();
+    // Rows without an item keep stale raw values; 'present' says which are valid
+    scale(&rawTime[from], &timeOfDay[from], n, 1.0 / 128.0);
+    scale(&rawRho[from], &rho[from], n, 1.0 / 256.0);
+    scale(&rawTheta[from], &theta[from], n, 360.0 / 65536.0);
+    scale(&rawFlightLevel[from], &flightLevel[from], n, 0.25);
+    scale(&rawSpeed[from], &groundSpeed[from], n, 1.0 / 16384.0);
+    scale(&rawHeading[from], &heading[from], n, 360.0 / 65536.0);
+}
+
+const char* PlotColumns::kernel() { return simdName(simdLevel()); }
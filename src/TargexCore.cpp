@@ -1,4 +1,5 @@
 #include "TargexCore.hpp"
+#include "PacketRing.hpp"
 #include <iostream>
 #include <thread>
 #include "Logger.hpp"
@@ -8,6 +9,7 @@
 #include <iomanip>
 #include <ctime>
 #include <sstream>
+#include <chrono>
 
 namespace fs = std::filesystem;
 
@@ -34,7 +36,26 @@ void TargexCore::startCapture() {
 
     // 3. [CRITICAL] Register as Active File
     m_config.active_pcap_path = filename;
-    // 4. Start Dumpcap
+    // 4a. Shared ring: take a handle to each captured frame
+    if (m_ring) {
+        if (!m_writer.open(filename, m_ring->linkType())) {
+            m_config.active_pcap_path = "";
+            return;
+        }
+        m_isCapturing = true;
+        m_captureThread = std::thread(&TargexCore::captureLoop, this);
+        m_sinkId = m_ring->addSink([this](const PacketRef& pkt) {
+            {
+                std::lock_guard<std::mutex> lock(m_queueMutex);
+                m_recordQueue.push_back(pkt);
+            }
+            m_recordCv.notify_one();
+        });
+        Logger::info("[CORE] Recording from shared capture ring: {}", filename);
+        return;
+    }
+
+    // 4b. Start Dumpcap
     std::string filter = "udp port " + std::to_string(m_config.rx_port);
     std::string recCmd = "dumpcap -q -i " + m_config.interface + 
                          " -f \"" + filter + "\"" +
@@ -53,10 +74,47 @@ void TargexCore::startCapture() {
 void TargexCore::stopCapture() {
     if (!m_isCapturing) return;
     
-    system("pkill -9 dumpcap");
+    if (m_ring) {
+        m_ring->removeSink(m_sinkId);
+        m_sinkId = -1;
+        m_isCapturing = false;
+        m_recordCv.notify_one();
+        if (m_captureThread.joinable()) m_captureThread.join();
+        m_writer.close();
+    } else {
+        system("pkill -9 dumpcap");
+    }
     m_isCapturing = false;
 
     // 5. [CRITICAL] Clear Active File
     m_config.active_pcap_path = "";
     Logger::info("[CORE] Recording Stopped.");
-}
\ No newline at end of file
+}
+
+void TargexCore::captureLoop() {
+    auto lastFlush = std::chrono::steady_clock::now();
+    std::deque<PacketRef> batch;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_recordCv.wait_for(lock, std::chrono::milliseconds(500),
+                                [this] { return !m_recordQueue.empty() || !m_isCapturing; });
+            batch.swap(m_recordQueue);
+        }
+
+        for (const auto& pkt : batch) {
+            m_writer.write(pkt->tsSec, pkt->tsNsec, pkt->data, pkt->len, pkt->origLen);
+        }
+        batch.clear(); // Releases the buffers back to the pool
+
+        // Keep the file readable by /api/merge while recording
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastFlush > std::chrono::seconds(1)) { m_writer.flush(); lastFlush = now; }
+
+        if (!m_isCapturing) {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            if (m_recordQueue.empty()) break;
+        }
+    }
+}
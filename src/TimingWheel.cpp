@@ -0,0 +1,136 @@
+#include "TimingWheel.hpp"
+#include <algorithm>
+
+TimingWheel::TimingWheel(uint64_t nowMs) : m_now(nowMs) {
+    std::fill(std::begin(m_heads), std::end(m_heads), NIL);
+}
+
+// Level by the highest 8-bit digit in which expiry and now differ, slot by
+// the expiry's digit at that level. A timer moves down one level each time
+// the wheel enters its slot (cascade), and fires from level 0.
+void TimingWheel::link(uint32_t n) {
+    Node& node = m_nodes[n];
+    uint64_t diff = node.expiry ^ m_now;
+    int level = 0;
+    while (level < LEVELS - 1 && (diff >> (SLOT_BITS * (level + 1))) != 0) level++;
+    uint32_t index = uint32_t(node.expiry >> (SLOT_BITS * level)) & (SLOTS - 1);
+    uint32_t slot = uint32_t(level) * SLOTS + index;
+
+    node.slot = uint16_t(slot);
+    node.prev = NIL;
+    node.next = m_heads[slot];
+    if (node.next != NIL) m_nodes[node.next].prev = n;
+    m_heads[slot] = n;
+    m_occupied[level][index / 64] |= uint64_t(1) << (index % 64);
+}
+
+void TimingWheel::unlink(uint32_t n) {
+    Node& node = m_nodes[n];
+    uint32_t slot = node.slot;
+    if (node.prev != NIL) m_nodes[node.prev].next = node.next;
+    else m_heads[slot] = node.next;
+    if (node.next != NIL) m_nodes[node.next].prev = node.prev;
+    if (m_heads[slot] == NIL) {
+        uint32_t level = slot / SLOTS, index = slot % SLOTS;
+        m_occupied[level][index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+    node.slot = 0xFFFF;
+}
+
+TimingWheel::TimerId TimingWheel::schedule(uint64_t delayMs, uint16_t kind, uint64_t payload) {
+    uint32_t n;
+    if (m_free != NIL) {
+        n = m_free;
+        m_free = m_nodes[n].next;
+    } else {
+        n = uint32_t(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+    Node& node = m_nodes[n];
+    // Due no earlier than the next tick, no later than the top level reaches
+    uint64_t top = m_now | ((uint64_t(1) << (SLOT_BITS * LEVELS)) - 1);
+    node.expiry = std::min(m_now + std::max<uint64_t>(delayMs, 1), top);
+    node.kind = kind;
+    node.payload = payload;
+    node.generation++;
+    link(n);
+    m_count++;
+    return TimerId(node.generation) << 32 | n;
+}
+
+bool TimingWheel::pending(TimerId id) const {
+    uint32_t n = uint32_t(id);
+    return n < m_nodes.size() && m_nodes[n].generation == uint32_t(id >> 32) && m_nodes[n].slot != 0xFFFF;
+}
+
+bool TimingWheel::cancel(TimerId id) {
+    if (!pending(id)) return false;
+    uint32_t n = uint32_t(id);
+    unlink(n);
+    m_nodes[n].next = m_free;
+    m_free = n;
+    m_count--;
+    return true;
+}
+
+int TimingWheel::nextOccupied(int level, uint32_t from) const {
+    for (uint32_t word = from / 64; word < SLOTS / 64; ++word) {
+        uint64_t bits = m_occupied[level][word];
+        if (word == from / 64) bits &= ~uint64_t(0) << (from % 64);
+        if (bits) return int(word * 64 + __builtin_ctzll(bits));
+    }
+    return -1;
+}
+
+// Relink the slot of 'level' the wheel has just entered, one level down
+void TimingWheel::cascade(int level) {
+    uint32_t slot = uint32_t(level) * SLOTS + (uint32_t(m_now >> (SLOT_BITS * level)) & (SLOTS - 1));
+    uint32_t n = m_heads[slot];
+    m_heads[slot] = NIL;
+    uint32_t index = slot % SLOTS;
+    m_occupied[level][index / 64] &= ~(uint64_t(1) << (index % 64));
+    while (n != NIL) {
+        uint32_t next = m_nodes[n].next;
+        link(n);
+        n = next;
+    }
+}
+
+size_t TimingWheel::advance(uint64_t nowMs, std::vector<Fired>& out) {
+    size_t fired = 0;
+    while (m_now < nowMs) {
+        // Jump to the next occupied level-0 slot, or to the end of this turn
+        uint32_t index = uint32_t(m_now) & (SLOTS - 1);
+        int occupied = (index == SLOTS - 1) ? -1 : nextOccupied(0, index + 1);
+        uint64_t target = (occupied >= 0) ? (m_now & ~uint64_t(SLOTS - 1)) + uint64_t(occupied)
+                                          : (m_now | (SLOTS - 1)) + 1;
+        if (target > nowMs) { m_now = nowMs; break; }
+        m_now = target;
+
+        // Entering a new turn: bring the upper slots now current down, top first
+        if ((m_now & (SLOTS - 1)) == 0) {
+            int top = 1;
+            while (top < LEVELS - 1 && (m_now & ((uint64_t(1) << (SLOT_BITS * (top + 1))) - 1)) == 0) top++;
+            for (int level = top; level >= 1; --level) cascade(level);
+        }
+
+        uint32_t slot = uint32_t(m_now) & (SLOTS - 1);
+        for (uint32_t n = m_heads[slot]; n != NIL; n = m_heads[slot]) {
+            Node& node = m_nodes[n];
+            out.push_back({TimerId(node.generation) << 32 | n, node.kind, node.payload});
+            unlink(n);
+            node.next = m_free;
+            m_free = n;
+            m_count--;
+            fired++;
+        }
+    }
+    return fired;
+}
+
+uint64_t TimingWheel::nextDueMs(uint64_t limit) const {
+    uint32_t index = uint32_t(m_now) & (SLOTS - 1);
+    int occupied = (index == SLOTS - 1) ? -1 : nextOccupied(0, index + 1);
+    uint64_t due = (occupied >= 0) ? uint64_t(occupied) - index : SLOTS - index;
+    return std::min(due, limit);
+}
@@ -0,0 +1,219 @@
+#include "TrackFusion.hpp"
+#include <algorithm>
+#include <cmath>
+
+constexpr size_t MAX_RECENT = 64;   // More new fused tracks than this: rebuild instead of scanning
+
+static double distanceM(const TrackStore& a, size_t rowA, const TrackStore& b, size_t rowB, double now) {
+    double latA, lonA, latB, lonB;
+    a.positionAt(rowA, now, latA, lonA);
+    b.positionAt(rowB, now, latB, lonB);
+    double north = (latA - latB) / TrackStore::DEG_PER_M;
+    double east = (lonA - lonB) / b.lonScale[rowB];
+    return std::hypot(north, east);
+}
+
+static bool addressConflict(const TrackStore& a, size_t rowA, const TrackStore& b, size_t rowB) {
+    return (a.flags[rowA] & TRK_ADDRESS) && (b.flags[rowB] & TRK_ADDRESS) && a.address[rowA] != b.address[rowB];
+}
+
+bool TrackFusion::discreteMode3A(uint16_t code) {
+    switch (code) {
+        case 00000: case 01000: case 01200: case 02000: case 07000: return false;
+        default: return true;
+    }
+}
+
+// --- GRID ---
+uint64_t TrackFusion::cellOf(double lat, double lon, int dLat, int dLon) {
+    const int64_t lonCells = int64_t(360.0 / GRID_DEG);
+    int64_t y = int64_t(std::floor(lat / GRID_DEG)) + dLat;
+    int64_t x = (int64_t(std::floor(lon / GRID_DEG)) + dLon) % lonCells;
+    if (x < 0) x += lonCells;   // Wraps at the antimeridian
+    return uint64_t(y + lonCells) << 32 | uint64_t(x);
+}
+
+const TrackFusion::CellSlot* TrackFusion::findCell(uint64_t cell) const {
+    if (m_cells.empty()) return nullptr;
+    size_t mask = m_cells.size() - 1;
+    for (size_t i = slotOf(cell);; i = (i + 1) & mask) {
+        if (m_cells[i].cell == cell) return &m_cells[i];
+        if (m_cells[i].cell == EMPTY_CELL) return nullptr;
+    }
+}
+
+void TrackFusion::rebuild(const TrackStore& fused, double now) {
+    m_entries.clear();
+    m_byAddress.clear();
+    m_byMode3A.clear();
+    for (size_t row = 0; row < fused.count; ++row) {
+        uint8_t flags = fused.flags[row];
+        if (!(flags & TRK_POSITION)) continue;
+        double lat, lon;
+        fused.positionAt(row, now, lat, lon);
+        uint64_t key = fused.trackKey[row];
+        m_entries.push_back({cellOf(lat, lon), key});
+        if (flags & TRK_ADDRESS) m_byAddress.push_back({fused.address[row], key});
+        if ((flags & TRK_MODE3A) && discreteMode3A(fused.mode3A[row])) m_byMode3A.push_back({fused.mode3A[row], key});
+    }
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) { return a.cell < b.cell; });
+    std::sort(m_byAddress.begin(), m_byAddress.end());
+    std::sort(m_byMode3A.begin(), m_byMode3A.end());
+
+    // Cells at most half the table
+    size_t n = 64;
+    while (n < m_entries.size() * 2) n <<= 1;
+    m_cells.assign(n, CellSlot());
+    m_shift = 64;
+    for (size_t v = n; v > 1; v >>= 1) m_shift--;
+    for (size_t i = 0; i < m_entries.size();) {
+        size_t j = i;
+        while (j < m_entries.size() && m_entries[j].cell == m_entries[i].cell) ++j;
+        size_t slot = slotOf(m_entries[i].cell);
+        while (m_cells[slot].cell != EMPTY_CELL) slot = (slot + 1) & (n - 1);
+        m_cells[slot] = {m_entries[i].cell, uint32_t(i), uint32_t(j - i)};
+        i = j;
+    }
+    m_recent.clear();
+}
+
+// --- ASSOCIATION ---
+// A sensor track already in this fused track from the same sensor (same
+// kind, SAC and SIC) means these are two different targets
+bool TrackFusion::sameSensorMember(const TrackStore& sensors, size_t row, const TrackStore& fused, size_t fusedRow) const {
+    uint64_t key = sensors.trackKey[row];
+    uint64_t fusedKey = fused.trackKey[fusedRow];
+    for (size_t i = 0; i < TrackStore::MAX_MEMBERS; ++i) {
+        uint64_t m = fused.membersOf(fusedRow)[i];
+        if (m == 0 || m == key || (m >> 32) != (key >> 32)) continue;
+        long other = sensors.find(m);
+        if (other >= 0 && sensors.link[other] == fusedKey) return true;
+    }
+    return false;
+}
+
+// Fused row of 'key' if it is a closer acceptable match than 'bestDistance'
+long TrackFusion::candidate(const TrackStore& sensors, size_t row, const TrackStore& fused, uint64_t key,
+                            double now, double gate, double& bestDistance) const {
+    long fusedRow = fused.find(key);
+    if (fusedRow < 0 || !(fused.flags[fusedRow] & TRK_POSITION)) return -1;
+    if (addressConflict(sensors, row, fused, fusedRow)) return -1;
+    double d = distanceM(sensors, row, fused, fusedRow, now);
+    if (d > gate || d >= bestDistance) return -1;
+    if (sameSensorMember(sensors, row, fused, fusedRow)) return -1;
+    bestDistance = d;
+    return fusedRow;
+}
+
+size_t TrackFusion::associate(TrackStore& sensors, size_t row, TrackStore& fused, double now, bool* created) {
+    *created = false;
+    if (m_recent.size() >= MAX_RECENT) rebuild(fused, now);
+
+    // Sticky: an association holds while the tracks stay consistent
+    if (sensors.link[row]) {
+        long fusedRow = fused.find(sensors.link[row]);
+        if (fusedRow >= 0 && !addressConflict(sensors, row, fused, fusedRow) &&
+            distanceM(sensors, row, fused, fusedRow, now) <= KEEP_GATE_M) {
+            fold(sensors, row, fused, size_t(fusedRow), now);
+            return size_t(fusedRow);
+        }
+        sensors.link[row] = 0;   // Its member slot goes stale and is reused
+    }
+
+    long best = -1;
+    double bestDistance;
+    auto byIdentity = [&](const std::vector<Identity>& index, uint32_t code, uint8_t flag, const std::vector<uint16_t>* codes16,
+                          const std::vector<uint32_t>* codes32, double gate) {
+        bestDistance = gate;
+        auto range = std::equal_range(index.begin(), index.end(), Identity{code, 0});
+        for (auto it = range.first; it != range.second; ++it) {
+            long c = candidate(sensors, row, fused, it->track, now, gate, bestDistance);
+            if (c >= 0) best = c;
+        }
+        for (uint64_t key : m_recent) {
+            long r = fused.find(key);
+            if (r < 0 || !(fused.flags[r] & flag)) continue;
+            uint32_t other = codes32 ? (*codes32)[r] : (*codes16)[r];
+            if (other != code) continue;
+            long c = candidate(sensors, row, fused, key, now, gate, bestDistance);
+            if (c >= 0) best = c;
+        }
+    };
+
+    // Fast paths: the same transponder is the same aircraft
+    uint8_t flags = sensors.flags[row];
+    if (flags & TRK_ADDRESS) {
+        byIdentity(m_byAddress, sensors.address[row], TRK_ADDRESS, nullptr, &fused.address, IDENTITY_GATE_M);
+    }
+    if (best < 0 && (flags & TRK_MODE3A) && discreteMode3A(sensors.mode3A[row])) {
+        byIdentity(m_byMode3A, sensors.mode3A[row], TRK_MODE3A, &fused.mode3A, nullptr, 2 * GATE_M);
+    }
+
+    // Position gate over the neighbouring grid cells
+    if (best < 0) {
+        bestDistance = GATE_M;
+        double lat, lon;
+        sensors.positionAt(row, now, lat, lon);
+        for (int dLat = -1; dLat <= 1; ++dLat) {
+            for (int dLon = -1; dLon <= 1; ++dLon) {
+                const CellSlot* cell = findCell(cellOf(lat, lon, dLat, dLon));
+                if (!cell) continue;
+                for (uint32_t i = cell->start; i < cell->start + cell->count; ++i) {
+                    long c = candidate(sensors, row, fused, m_entries[i].track, now, GATE_M, bestDistance);
+                    if (c >= 0) best = c;
+                }
+            }
+        }
+        for (uint64_t key : m_recent) {
+            long c = candidate(sensors, row, fused, key, now, GATE_M, bestDistance);
+            if (c >= 0) best = c;
+        }
+    }
+
+    if (best < 0) {
+        uint64_t key = TrackStore::key(TRACK_FUSED, 0, 0, ++m_nextId);
+        best = long(fused.upsert(key, now));
+        m_recent.push_back(key);
+        *created = true;
+    }
+    fold(sensors, row, fused, size_t(best), now);
+    return size_t(best);
+}
+
+// Sensor track state into the fused track: position through the fused
+// track's filter, identity as far as the sensor knows it
+void TrackFusion::fold(TrackStore& sensors, size_t row, TrackStore& fused, size_t fusedRow, double now) {
+    uint64_t key = sensors.trackKey[row];
+    uint64_t fusedKey = fused.trackKey[fusedRow];
+    fused.upsert(fusedKey, now);   // lastUpdate, update count
+
+    double lat, lon;
+    sensors.positionAt(row, now, lat, lon);
+    double velocity[2] = {sensors.vx[row], sensors.vy[row]};
+    uint8_t flags = sensors.flags[row];
+    fused.filterUpdate(fusedRow, lat, lon, now, (flags & TRK_VELOCITY) ? velocity : nullptr);
+
+    fused.category[fusedRow] = sensors.category[row];
+    fused.timeOfDay[fusedRow] = sensors.timeOfDay[row];
+    if (flags & TRK_FLIGHT_LEVEL) { fused.flightLevel[fusedRow] = sensors.flightLevel[row]; fused.flags[fusedRow] |= TRK_FLIGHT_LEVEL; }
+    if (flags & TRK_ADDRESS) { fused.address[fusedRow] = sensors.address[row]; fused.flags[fusedRow] |= TRK_ADDRESS; }
+    if (flags & TRK_MODE3A) { fused.mode3A[fusedRow] = sensors.mode3A[row]; fused.flags[fusedRow] |= TRK_MODE3A; }
+    if (sensors.callsignOf(row)[0]) std::copy_n(sensors.callsignOf(row), TrackStore::CALLSIGN_LEN, fused.callsignOf(fusedRow));
+    // Named after its first sensor track, or the address once one reports it
+    if (!fused.labelOf(fusedRow)[0] || TrackStore::kindOf(key) == TRACK_ADDRESS) {
+        std::copy_n(sensors.labelOf(row), TrackStore::LABEL_LEN, fused.labelOf(fusedRow));
+    }
+
+    // Membership: reuse a free or stale slot, else the last one
+    sensors.link[row] = fusedKey;
+    uint64_t* members = fused.membersOf(fusedRow);
+    size_t slot = TrackStore::MAX_MEMBERS - 1;
+    for (size_t i = 0; i < TrackStore::MAX_MEMBERS; ++i) {
+        if (members[i] == key) return;
+    }
+    for (size_t i = 0; i < TrackStore::MAX_MEMBERS; ++i) {
+        long other = members[i] ? sensors.find(members[i]) : -1;
+        if (other < 0 || sensors.link[other] != fusedKey) { slot = i; break; }
+    }
+    members[slot] = key;
+}
@@ -0,0 +1,283 @@
+#include "TrackStore.hpp"
+#include "SimdLevel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+constexpr double PI = 3.14159265358979323846;
+
+// Gains for radar scans of 4-12 s: alpha trades noise against lag,
+// beta = alpha^2 / (2 - alpha) (Benedict-Bordner)
+constexpr double FILTER_ALPHA = 0.5;
+constexpr double FILTER_BETA = FILTER_ALPHA * FILTER_ALPHA / (2.0 - FILTER_ALPHA);
+
+TrackStore::TrackStore(size_t capacity) {
+    size_t rows = capacity ? capacity : 1;
+    resizeRows(rows);
+
+    size_t n = 64;
+    while (n < rows * 2) n <<= 1;
+    m_index.assign(n, EMPTY);
+    m_mask = n - 1;
+    m_shift = 64;
+    for (size_t v = n; v > 1; v >>= 1) m_shift--;
+}
+
+void TrackStore::resizeRows(size_t n) {
+    trackKey.resize(n);
+    flags.resize(n);
+    category.resize(n);
+    quality.resize(n);
+    lastUpdate.resize(n);
+    timeOfDay.resize(n);
+    lat.resize(n);
+    lon.resize(n);
+    vx.resize(n);
+    vy.resize(n);
+    stateTime.resize(n);
+    lonScale.resize(n);
+    predLat.resize(n);
+    predLon.resize(n);
+    flightLevel.resize(n);
+    address.resize(n);
+    mode3A.resize(n);
+    link.resize(n);
+    members.resize(n * MAX_MEMBERS);
+    label.resize(n * LABEL_LEN);
+    callsign.resize(n * CALLSIGN_LEN);
+}
+
+void TrackStore::growIndex() {
+    m_index.assign(m_index.size() * 2, EMPTY);
+    m_mask = m_index.size() - 1;
+    m_shift--;
+    for (size_t row = 0; row < count; ++row) {
+        size_t i = slotOf(trackKey[row]);
+        while (m_index[i] != EMPTY) i = (i + 1) & m_mask;
+        m_index[i] = uint32_t(row);
+    }
+}
+
+size_t TrackStore::upsert(uint64_t k, double now, bool* created) {
+    size_t i = slotOf(k);
+    for (; m_index[i] != EMPTY; i = (i + 1) & m_mask) {
+        size_t row = m_index[i];
+        if (trackKey[row] == k) {
+            lastUpdate[row] = now;
+            if (quality[row] < 255) quality[row]++;
+            if (created) *created = false;
+            return row;
+        }
+    }
+    if (created) *created = true;
+
+    if (count == trackKey.size()) resizeRows(count * 2);
+    // Index load stays under 1/2: probe runs of one or two slots
+    if ((count + 1) * 2 > m_index.size()) {
+        growIndex();
+        i = slotOf(k);
+        while (m_index[i] != EMPTY) i = (i + 1) & m_mask;
+    }
+    size_t row = count++;
+    m_index[i] = uint32_t(row);
+    trackKey[row] = k;
+    flags[row] = 0;
+    category[row] = 0;
+    quality[row] = 1;
+    lastUpdate[row] = now;
+    timeOfDay[row] = -1;
+    lat[row] = lon[row] = 0;
+    vx[row] = vy[row] = 0;
+    stateTime[row] = now;
+    lonScale[row] = DEG_PER_M;
+    flightLevel[row] = 0;
+    address[row] = 0;
+    mode3A[row] = 0;
+    link[row] = 0;
+    std::fill_n(membersOf(row), MAX_MEMBERS, 0);
+    labelOf(row)[0] = '\0';
+    callsignOf(row)[0] = '\0';
+    return row;
+}
+
+long TrackStore::find(uint64_t k) const {
+    for (size_t i = slotOf(k); m_index[i] != EMPTY; i = (i + 1) & m_mask) {
+        if (trackKey[m_index[i]] == k) return long(m_index[i]);
+    }
+    return -1;
+}
+
+size_t TrackStore::slotOfRow(size_t row) const {
+    size_t i = slotOf(trackKey[row]);
+    while (m_index[i] != row) i = (i + 1) & m_mask;
+    return i;
+}
+
+// Backward-shift deletion, as in AdsbTable: no tombstones
+void TrackStore::eraseSlot(size_t slot) {
+    size_t hole = slot;
+    for (size_t i = (slot + 1) & m_mask; m_index[i] != EMPTY; i = (i + 1) & m_mask) {
+        size_t home = slotOf(trackKey[m_index[i]]);
+        if (((i - home) & m_mask) >= ((i - hole) & m_mask)) {
+            m_index[hole] = m_index[i];
+            hole = i;
+        }
+    }
+    m_index[hole] = EMPTY;
+}
+
+void TrackStore::remove(size_t row) {
+    eraseSlot(slotOfRow(row));
+    size_t last = --count;
+    if (row == last) return;
+
+    // The last row fills the hole; its index slot follows it
+    m_index[slotOfRow(last)] = uint32_t(row);
+    trackKey[row] = trackKey[last];
+    flags[row] = flags[last];
+    category[row] = category[last];
+    quality[row] = quality[last];
+    lastUpdate[row] = lastUpdate[last];
+    timeOfDay[row] = timeOfDay[last];
+    lat[row] = lat[last];
+    lon[row] = lon[last];
+    vx[row] = vx[last];
+    vy[row] = vy[last];
+    stateTime[row] = stateTime[last];
+    lonScale[row] = lonScale[last];
+    flightLevel[row] = flightLevel[last];
+    address[row] = address[last];
+    mode3A[row] = mode3A[last];
+    link[row] = link[last];
+    std::copy_n(membersOf(last), MAX_MEMBERS, membersOf(row));
+    memcpy(labelOf(row), labelOf(last), LABEL_LEN);
+    memcpy(callsignOf(row), callsignOf(last), CALLSIGN_LEN);
+}
+
+bool TrackStore::erase(uint64_t k) {
+    long row = find(k);
+    if (row < 0) return false;
+    remove(size_t(row));
+    return true;
+}
+
+void TrackStore::clear() {
+    std::fill(m_index.begin(), m_index.end(), EMPTY);
+    count = 0;
+}
+
+void TrackStore::uid(size_t row, char* out, size_t len) const {
+    uint64_t k = trackKey[row];
+    switch (kindOf(k)) {
+        case TRACK_ADDRESS:
+            snprintf(out, len, "GNE-ICAO-%06X", numberOf(k));
+            break;
+        case TRACK_FUSED:
+            snprintf(out, len, "GNE-FUS-%u", numberOf(k));
+            break;
+        case TRACK_SYSTEM:
+            snprintf(out, len, "GNE-SYS-%u-%u-%u", unsigned(sacOf(k)), unsigned(sicOf(k)), numberOf(k));
+            break;
+        default:
+            snprintf(out, len, "GNE-TRK-%u-%u-%u", unsigned(sacOf(k)), unsigned(sicOf(k)), numberOf(k));
+            break;
+    }
+}
+
+// --- FILTER ---
+void TrackStore::filterUpdate(size_t row, double measLat, double measLon, double t, const double* velocity) {
+    uint8_t& f = flags[row];
+    if (!(f & TRK_POSITION)) {
+        // First position: taken as is
+        lat[row] = measLat;
+        lon[row] = measLon;
+    } else {
+        // Predict to the measurement, then correct by the residual (metres)
+        double dt = std::max(t - stateTime[row], 0.0);   // Late reports correct in place
+        double predLatRow, predLonRow;
+        positionAt(row, stateTime[row] + dt, predLatRow, predLonRow);
+        double rNorth = (measLat - predLatRow) / DEG_PER_M;
+        double rEast = (measLon - predLonRow) / lonScale[row];
+        // Second position without a sensor velocity: the difference is the velocity
+        bool init = !(f & TRK_VELOCITY);
+        double alpha = init ? 1.0 : FILTER_ALPHA;
+        lat[row] = predLatRow + alpha * rNorth * DEG_PER_M;
+        lon[row] = predLonRow + alpha * rEast * lonScale[row];
+        if (!velocity && dt > 0) {
+            double beta = init ? 1.0 : FILTER_BETA;
+            vx[row] += beta * rEast / dt;
+            vy[row] += beta * rNorth / dt;
+            f |= TRK_VELOCITY;
+        }
+    }
+    if (velocity) { vx[row] = velocity[0]; vy[row] = velocity[1]; f |= TRK_VELOCITY; }
+    f |= TRK_POSITION;
+    stateTime[row] = std::max(stateTime[row], t);   // A late report does not move the state back
+    lonScale[row] = DEG_PER_M / std::max(std::cos(lat[row] * PI / 180.0), 0.01);
+}
+
+// --- PREDICTION KERNELS ---
+// positionAt() over rows [from, n): predLat = lat + vy * dt * DEG_PER_M,
+// predLon = lon + vx * dt * lonScale, dt = now - stateTime
+struct PredictColumns {
+    const double* lat; const double* lon;
+    const double* vx; const double* vy;
+    const double* stateTime; const double* lonScale;
+    double* predLat; double* predLon;
+};
+using PredictKernel = void (*)(const PredictColumns& c, size_t from, size_t n, double now);
+
+static void predictScalar(const PredictColumns& c, size_t from, size_t n, double now) {
+    for (size_t i = from; i < n; ++i) {
+        double dt = now - c.stateTime[i];
+        c.predLat[i] = c.lat[i] + c.vy[i] * dt * TrackStore::DEG_PER_M;
+        c.predLon[i] = c.lon[i] + c.vx[i] * dt * c.lonScale[i];
+    }
+}
+
+#ifdef SIMD_X86
+__attribute__((target("sse2")))
+static void predictSse2(const PredictColumns& c, size_t from, size_t n, double now) {
+    const __m128d t = _mm_set1_pd(now), k = _mm_set1_pd(TrackStore::DEG_PER_M);
+    size_t i = from;
+    for (; i + 2 <= n; i += 2) {
+        __m128d dt = _mm_sub_pd(t, _mm_loadu_pd(c.stateTime + i));
+        __m128d dLat = _mm_mul_pd(_mm_mul_pd(_mm_loadu_pd(c.vy + i), dt), k);
+        __m128d dLon = _mm_mul_pd(_mm_mul_pd(_mm_loadu_pd(c.vx + i), dt), _mm_loadu_pd(c.lonScale + i));
+        _mm_storeu_pd(c.predLat + i, _mm_add_pd(_mm_loadu_pd(c.lat + i), dLat));
+        _mm_storeu_pd(c.predLon + i, _mm_add_pd(_mm_loadu_pd(c.lon + i), dLon));
+    }
+    predictScalar(c, i, n, now);
+}
+
+__attribute__((target("avx2")))
+static void predictAvx2(const PredictColumns& c, size_t from, size_t n, double now) {
+    const __m256d t = _mm256_set1_pd(now), k = _mm256_set1_pd(TrackStore::DEG_PER_M);
+    size_t i = from;
+    for (; i + 4 <= n; i += 4) {
+        __m256d dt = _mm256_sub_pd(t, _mm256_loadu_pd(c.stateTime + i));
+        __m256d dLat = _mm256_mul_pd(_mm256_mul_pd(_mm256_loadu_pd(c.vy + i), dt), k);
+        __m256d dLon = _mm256_mul_pd(_mm256_mul_pd(_mm256_loadu_pd(c.vx + i), dt), _mm256_loadu_pd(c.lonScale + i));
+        _mm256_storeu_pd(c.predLat + i, _mm256_add_pd(_mm256_loadu_pd(c.lat + i), dLat));
+        _mm256_storeu_pd(c.predLon + i, _mm256_add_pd(_mm256_loadu_pd(c.lon + i), dLon));
+    }
+    predictScalar(c, i, n, now);
+}
+#endif
+
+static PredictKernel predictKernel() {
+#ifdef SIMD_X86
+    return simdKernel<PredictKernel>(predictScalar, predictSse2, predictAvx2);
+#else
+    return simdKernel<PredictKernel>(predictScalar);
+#endif
+}
+
+const char* TrackStore::kernel() { return simdName(simdLevel()); }
+
+void TrackStore::predict(double now) {
+    PredictColumns c{lat.data(), lon.data(), vx.data(), vy.data(), stateTime.data(), lonScale.data(),
+                     predLat.data(), predLon.data()};
+    predictKernel()(c, 0, count, now);
+}
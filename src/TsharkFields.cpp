@@ -0,0 +1,171 @@
+#include "TsharkFields.hpp"
+#include "EkExtractor.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+// Joins the occurrences of a field within one packet ("-E aggregator=")
+static const char AGGREGATOR = ',';
+
+// Known field names -> role. Both spellings are listed where tshark releases
+// and resources/tshark_config.json disagree.
+struct RoleName { const char* field; TsharkFields::Role role; };
+static const RoleName ROLE_NAMES[] = {
+    {"asterix.034_010_SAC",   TsharkFields::ROLE_SAC},
+    {"asterix.034_010_SIC",   TsharkFields::ROLE_SIC},
+    {"asterix.048_010_SAC",   TsharkFields::ROLE_SAC},
+    {"asterix.048_010_SIC",   TsharkFields::ROLE_SIC},
+    {"asterix.034_000_VALUE", TsharkFields::ROLE_MESSAGE_TYPE},
+    {"asterix.034_000_MT",    TsharkFields::ROLE_MESSAGE_TYPE},
+    {"asterix.034_030_VALUE", TsharkFields::ROLE_TIME},
+    {"asterix.034_030",       TsharkFields::ROLE_TIME},
+    {"asterix.048_140_VALUE", TsharkFields::ROLE_TIME},
+    {"asterix.048_140",       TsharkFields::ROLE_TIME},
+    {"asterix.034_120_LAT",   TsharkFields::ROLE_LAT},
+    {"asterix.034_120_LON",   TsharkFields::ROLE_LON},
+    {"asterix.034_120_H",     TsharkFields::ROLE_HEIGHT},
+    {"asterix.034_120_HGT",   TsharkFields::ROLE_HEIGHT},
+    {"asterix.048_040_RHO",   TsharkFields::ROLE_RHO},
+    {"asterix.048_040_THETA", TsharkFields::ROLE_THETA},
+    {"asterix.048_161_TN",    TsharkFields::ROLE_TRACK_NUMBER},
+    {"asterix.048_161_TRN",   TsharkFields::ROLE_TRACK_NUMBER},
+    {"asterix.048_042_X",     TsharkFields::ROLE_X},
+    {"asterix.048_042_Y",     TsharkFields::ROLE_Y},
+    {"asterix.048_200_GS",    TsharkFields::ROLE_GROUND_SPEED},
+    {"asterix.048_200_GSP",   TsharkFields::ROLE_GROUND_SPEED},
+    {"asterix.048_200_HDG",   TsharkFields::ROLE_HEADING},
+    {"asterix.048_020_TYP",   TsharkFields::ROLE_REPORT_TYPE},
+    {"asterix.048_170_CNF",   TsharkFields::ROLE_TRACK_STATUS},
+};
+
+// Always requested, whatever the mapping file says
+static const char* CORE_FIELDS[] = {
+    "asterix.034_010_SAC", "asterix.034_010_SIC",
+    "asterix.048_010_SAC", "asterix.048_010_SIC",
+    "asterix.034_120_LAT", "asterix.034_120_LON",
+    "asterix.048_040_RHO", "asterix.048_040_THETA",
+    "asterix.048_161_TN",
+    "asterix.048_200_GS", "asterix.048_200_HDG",
+};
+
+std::vector<std::string> TsharkFields::queryKnownFields() {
+    std::vector<std::string> known;
+    FILE* pipe = popen("tshark -G fields 2>/dev/null", "r");
+    if (!pipe) return known;
+
+    // Rows: "F<TAB>Name<TAB>abbrev<TAB>..."
+    char buffer[4096];
+    while (fgets(buffer, sizeof(buffer), pipe)) {
+        if (buffer[0] != 'F' || buffer[1] != '\t') continue;
+        char* abbrev = strchr(buffer + 2, '\t');
+        if (!abbrev) continue;
+        abbrev++;
+        char* end = strchr(abbrev, '\t');
+        if (!end) continue;
+        if (strncmp(abbrev, "asterix.", 8) == 0) known.emplace_back(abbrev, size_t(end - abbrev));
+    }
+    pclose(pipe);
+    std::sort(known.begin(), known.end());
+    return known;
+}
+
+void TsharkFields::configure(const std::vector<AsterixMapping>& mapping, const std::vector<std::string>& known) {
+    m_columns.clear();
+
+    auto addColumn = [&](const std::string& field) {
+        for (const auto& c : m_columns) if (c.field == field) return;
+        if (!known.empty() && !std::binary_search(known.begin(), known.end(), field)) {
+            Logger::warn("[MARS] tshark has no field '{}', column skipped", field);
+            return;
+        }
+
+        Column c;
+        c.field = field;
+        for (const auto& rn : ROLE_NAMES) {
+            if (field == rn.field) { c.role = rn.role; break; }
+        }
+        if (field.compare(0, 12, "asterix.034_") == 0) c.category = 34;
+        else if (field.compare(0, 12, "asterix.048_") == 0) c.category = 48;
+        m_columns.push_back(c);
+    };
+
+    for (const char* f : CORE_FIELDS) addColumn(f);
+    for (const auto& m : mapping) addColumn(m.source);
+}
+
+std::string TsharkFields::tsharkArgs() const {
+    std::string args = "-T fields -E separator=/t -E occurrence=a -E aggregator=";
+    args += AGGREGATOR;
+    for (const auto& c : m_columns) args += " -e " + c.field;
+    return args;
+}
+
+// Occurrence 'index' of a CAT034/CAT048 column lands in the index-th record
+// of that category, growing the record list as needed
+template <typename Record>
+static Record& recordAt(std::vector<Record>& records, size_t first, size_t index) {
+    while (records.size() <= first + index) records.emplace_back();
+    return records[first + index];
+}
+
+size_t TsharkFields::parse(const char* line, size_t len, std::vector<Cat034Record>& c034,
+                           std::vector<Cat048Record>& c048) const {
+    const size_t first034 = c034.size();
+    const size_t first048 = c048.size();
+
+    const char* p = line;
+    const char* end = line + len;
+    for (size_t i = 0; i < m_columns.size() && p <= end; ++i) {
+        const char* tab = static_cast<const char*>(memchr(p, '\t', size_t(end - p)));
+        const char* colEnd = tab ? tab : end;
+        const Column& col = m_columns[i];
+
+        // One value per record carrying the item, in datagram order
+        const char* v0 = p;
+        for (size_t occ = 0; col.role != ROLE_NONE && col.category != 0 && v0 < colEnd; ++occ) {
+            const char* sep = static_cast<const char*>(memchr(v0, AGGREGATOR, size_t(colEnd - v0)));
+            const char* vEnd = sep ? sep : colEnd;
+            double v = 0;
+            if (vEnd > v0 && EkExtractor::parseNumber(v0, vEnd, v)) {
+                if (col.category == 34) {
+                    Cat034Record& r = recordAt(c034, first034, occ);
+                    switch (col.role) {
+                        case ROLE_SAC:          r.sac = uint8_t(v); r.present |= C034_DATA_SOURCE; break;
+                        case ROLE_SIC:          r.sic = uint8_t(v); r.present |= C034_DATA_SOURCE; break;
+                        case ROLE_TIME:         r.timeOfDay = v; r.present |= C034_TIME; break;
+                        case ROLE_MESSAGE_TYPE: r.messageType = uint8_t(v); r.present |= C034_MESSAGE_TYPE; break;
+                        case ROLE_LAT:          r.lat = v; r.present |= C034_POSITION; break;
+                        case ROLE_LON:          r.lon = v; r.present |= C034_POSITION; break;
+                        case ROLE_HEIGHT:       r.height = v; r.present |= C034_POSITION; break;
+                        default: break;
+                    }
+                } else {
+                    Cat048Record& r = recordAt(c048, first048, occ);
+                    switch (col.role) {
+                        case ROLE_SAC:          r.sac = uint8_t(v); r.present |= C048_DATA_SOURCE; break;
+                        case ROLE_SIC:          r.sic = uint8_t(v); r.present |= C048_DATA_SOURCE; break;
+                        case ROLE_TIME:         r.timeOfDay = v; r.present |= C048_TIME; break;
+                        case ROLE_RHO:          r.rho = v; r.present |= C048_POLAR; break;
+                        case ROLE_THETA:        r.theta = v; r.present |= C048_POLAR; break;
+                        case ROLE_TRACK_NUMBER: r.trackNumber = uint16_t(v); r.present |= C048_TRACK_NUMBER; break;
+                        case ROLE_X:            r.x = v; r.present |= C048_CARTESIAN; break;
+                        case ROLE_Y:            r.y = v; r.present |= C048_CARTESIAN; break;
+                        case ROLE_GROUND_SPEED: r.groundSpeed = v; r.present |= C048_VELOCITY; break;
+                        case ROLE_HEADING:      r.heading = v; r.present |= C048_VELOCITY; break;
+                        case ROLE_REPORT_TYPE:  r.reportType = uint8_t(uint8_t(v) << 5); r.present |= C048_REPORT_TYPE; break;
+                        case ROLE_TRACK_STATUS: r.trackStatus = uint8_t(uint8_t(v) << 7); r.present |= C048_TRACK_STATUS; break;
+                        default: break;
+                    }
+                }
+            }
+            if (!sep) break;
+            v0 = sep + 1;
+        }
+        if (!tab) break;
+        p = tab + 1;
+    }
+
+    return (c034.size() - first034) + (c048.size() - first048);
+}
@@ -0,0 +1,193 @@
+#include "TsharkPool.hpp"
+#include "PcapWriter.hpp"
+#include "Logger.hpp"
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <cstring>
+#include <cerrno>
+
+TsharkPool::~TsharkPool() { stop(); }
+
+bool TsharkPool::start(int workers, int port, const std::string& outputArgs, bool ekOutput, Dispatch dispatch) {
+    stop();
+    m_dispatch = dispatch;
+    m_ekOutput = ekOutput;
+    m_port = port;
+
+    // A worker that exits must not take the whole process down with it
+    signal(SIGPIPE, SIG_IGN);
+
+    std::string cmd = "exec tshark -l -n -r - -d udp.port==" + std::to_string(port) + ",asterix " + outputArgs;
+    Logger::info("[TSHARK] Starting {} workers: {}", workers, cmd);
+
+    for (int i = 0; i < workers; ++i) {
+        auto w = std::make_unique<Worker>();
+        if (!spawn(*w, cmd)) { stop(); return false; }
+        m_workers.push_back(std::move(w));
+    }
+    return true;
+}
+
+bool TsharkPool::spawn(Worker& w, const std::string& cmd) {
+    int inPipe[2], outPipe[2];
+    if (pipe(inPipe) < 0) return false;
+    if (pipe(outPipe) < 0) { ::close(inPipe[0]); ::close(inPipe[1]); return false; }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        Logger::error("[TSHARK] fork failed: {}", strerror(errno));
+        ::close(inPipe[0]); ::close(inPipe[1]); ::close(outPipe[0]); ::close(outPipe[1]);
+        return false;
+    }
+    if (pid == 0) {
+        dup2(inPipe[0], STDIN_FILENO);
+        dup2(outPipe[1], STDOUT_FILENO);
+        ::close(inPipe[0]); ::close(inPipe[1]); ::close(outPipe[0]); ::close(outPipe[1]);
+        signal(SIGPIPE, SIG_DFL);
+        execl("/bin/sh", "sh", "-c", cmd.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+
+    ::close(inPipe[0]);
+    ::close(outPipe[1]);
+    fcntl(inPipe[1], F_SETFD, FD_CLOEXEC);
+    fcntl(outPipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(inPipe[1], F_SETFL, fcntl(inPipe[1], F_GETFL, 0) | O_NONBLOCK);
+
+    w.pid = pid;
+    w.in = inPipe[1];
+    w.out.attach(outPipe[0]);
+    PcapWriter::appendFileHeader(w.pending, PcapWriter::LINKTYPE_RAW, 65535);
+    flush(w);
+    return true;
+}
+
+bool TsharkPool::anyAlive() const {
+    for (const auto& w : m_workers) if (w->out.isOpen()) return true;
+    return false;
+}
+
+void TsharkPool::stop() {
+    for (auto& w : m_workers) retire(*w);
+    m_workers.clear();
+    m_done.clear();
+    m_emitSeq = m_submitSeq = 0;
+}
+
+// Close a worker; whatever it still owed is marked lost so the merge moves on
+void TsharkPool::retire(Worker& w) {
+    if (w.in != -1) { ::close(w.in); w.in = -1; }
+    w.out.close();
+    if (w.pid > 0) {
+        kill(w.pid, SIGTERM);
+        waitpid(w.pid, nullptr, 0);
+        w.pid = -1;
+    }
+    for (uint64_t seq : w.seqs) m_done[seq].clear();
+    m_dropped += w.seqs.size();
+    w.seqs.clear();
+    w.pending.clear();
+}
+
+size_t TsharkPool::pick(const uint8_t* p, uint32_t len) {
+    if (m_dispatch == Dispatch::SacSic) {
+        // I010 (SAC/SIC) is FRN 1 in every category we carry: first FSPEC
+        // bit set -> the two octets after the FSPEC
+        if (len > 3 && (p[3] & 0x80)) {
+            uint32_t i = 3;
+            while (i < len && (p[i] & 0x01)) ++i;
+            if (i + 2 < len) return (uint32_t(p[i + 1]) << 8 | p[i + 2]) % m_workers.size();
+        }
+    }
+    return m_next++ % m_workers.size();
+}
+
+void TsharkPool::submit(const PacketRef& pkt, const uint8_t* payload, uint32_t payloadLen) {
+    if (m_workers.empty() || payloadLen == 0) return;
+    Worker& w = *m_workers[pick(payload, payloadLen)];
+    if (w.in == -1 || w.pending.size() > MAX_PENDING) { m_dropped++; return; }
+
+    // Minimal IPv4/UDP wrapper so "-d udp.port==N,asterix" applies
+    uint8_t hdr[28] = {};
+    uint16_t ipLen = uint16_t(28 + payloadLen), udpLen = uint16_t(8 + payloadLen);
+    hdr[0] = 0x45; hdr[2] = uint8_t(ipLen >> 8); hdr[3] = uint8_t(ipLen);
+    hdr[8] = 64; hdr[9] = 17;
+    hdr[12] = 127; hdr[15] = 1;   // 127.0.0.1 -> 127.0.0.1
+    hdr[16] = 127; hdr[19] = 1;
+    uint32_t sum = 0;
+    for (int i = 0; i < 20; i += 2) sum += uint32_t(hdr[i]) << 8 | hdr[i + 1];
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    hdr[10] = uint8_t(~sum >> 8); hdr[11] = uint8_t(~sum);
+    hdr[22] = uint8_t(m_port >> 8); hdr[23] = uint8_t(m_port);
+    hdr[24] = uint8_t(udpLen >> 8); hdr[25] = uint8_t(udpLen);
+
+    m_scratch.assign(reinterpret_cast<const char*>(hdr), sizeof(hdr));
+    m_scratch.append(reinterpret_cast<const char*>(payload), payloadLen);
+    PcapWriter::appendRecord(w.pending, pkt->tsSec, pkt->tsNsec,
+                             reinterpret_cast<const uint8_t*>(m_scratch.data()),
+                             uint32_t(m_scratch.size()), uint32_t(m_scratch.size()));
+    w.seqs.push_back(m_submitSeq++);
+    flush(w);
+}
+
+void TsharkPool::flush(Worker& w) {
+    size_t off = 0;
+    while (off < w.pending.size() && w.in != -1) {
+        ssize_t n = ::write(w.in, w.pending.data() + off, w.pending.size() - off);
+        if (n > 0) { off += size_t(n); continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno == EAGAIN) break;
+        Logger::error("[TSHARK] Worker {} stopped accepting packets", w.pid);
+        retire(w);
+        return;
+    }
+    w.pending.erase(0, off);
+}
+
+int TsharkPool::poll(int timeoutMs, int wakeFd, const LineHandler& onLine) {
+    std::vector<struct pollfd> fds;
+    fds.reserve(m_workers.size() * 2 + 1);
+    for (auto& w : m_workers) {
+        if (w->out.isOpen()) fds.push_back({w->out.fd(), POLLIN, 0});
+        if (w->in != -1 && !w->pending.empty()) fds.push_back({w->in, POLLOUT, 0});
+    }
+    if (wakeFd >= 0) fds.push_back({wakeFd, POLLIN, 0});
+
+    int pr = ::poll(fds.data(), fds.size(), timeoutMs);
+    if (pr < 0 && errno != EINTR) return -1;
+
+    if (wakeFd >= 0 && (fds.back().revents & POLLIN)) {
+        uint64_t v;
+        while (::read(wakeFd, &v, sizeof(v)) > 0) {}
+    }
+
+    for (auto& w : m_workers) {
+        if (!w->pending.empty()) flush(*w);
+        if (!w->out.isOpen()) continue;
+
+        Worker* wp = w.get();
+        int r = w->out.read(0, [this, wp](const char* line, size_t len) {
+            if (m_ekOutput && len > 9 && memcmp(line, "{\"index\"", 8) == 0) return;
+            if (wp->seqs.empty()) return;   // Header or stray output
+            m_done[wp->seqs.front()].assign(line, len);
+            wp->seqs.pop_front();
+        });
+        if (r < 0) {
+            Logger::error("[TSHARK] Worker {} exited", wp->pid);
+            retire(*wp);
+        }
+    }
+
+    // Release everything that is now contiguous
+    int delivered = 0;
+    while (!m_done.empty() && m_done.begin()->first == m_emitSeq) {
+        auto it = m_done.begin();
+        if (!it->second.empty()) { onLine(it->second.data(), it->second.size()); delivered++; }
+        m_done.erase(it);
+        m_emitSeq++;
+    }
+    return delivered;
+}
@@ -0,0 +1,306 @@
+#include "UapSpec.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+using json = nlohmann::json;
+
+static constexpr int MAX_FIELD_BITS = 56;   // Always within 8 octets, whatever the bit offset
+
+static uint32_t sourceKey(uint8_t cat, uint8_t sac, uint8_t sic) {
+    return (uint32_t(cat) << 16) | (uint32_t(sac) << 8) | sic;
+}
+
+// Big-endian bit field; false if it runs past the item
+static bool readBits(const uint8_t* p, size_t len, uint32_t off, uint8_t bits, uint64_t& v) {
+    uint32_t first = off >> 3;
+    uint32_t last = (off + bits - 1) >> 3;
+    if (last >= len) return false;
+    v = 0;
+    for (uint32_t i = first; i <= last; ++i) v = (v << 8) | p[i];
+    v >>= 7 - ((off + bits - 1) & 7);
+    v &= (1ULL << bits) - 1;
+    return true;
+}
+
+// --- LOADING ---
+UapSpec::UapSpec() {
+    std::fill(std::begin(m_defaultEdition), std::end(m_defaultEdition), int16_t(-1));
+}
+
+bool UapSpec::parseItem(const json& j, uint8_t cat, const std::string& itemId, uint32_t index,
+                        std::vector<uint32_t>& subIndex) {
+    static const std::pair<const char*, UapItemType> TYPES[] = {
+        {"spare", UapItemType::Spare}, {"fixed", UapItemType::Fixed}, {"extended", UapItemType::Extended},
+        {"repetitive", UapItemType::Repetitive}, {"explicit", UapItemType::Explicit}, {"compound", UapItemType::Compound}
+    };
+
+    UapItem& it = m_layout[index];
+    std::string type = j.value("type", "spare");
+    auto t = std::find_if(std::begin(TYPES), std::end(TYPES), [&](const auto& e) { return type == e.first; });
+    if (t == std::end(TYPES)) {
+        Logger::error("[SPEC] CAT{:03d} I{}: unknown item type '{}'", cat, itemId, type);
+        return false;
+    }
+    it.type = t->second;
+    it.id = uint16_t(std::strtoul(itemId.c_str(), nullptr, 10));
+    it.len = uint16_t(j.value("len", 0));
+    it.ext = uint8_t(j.value("ext", 0));
+    if ((it.type == UapItemType::Fixed || it.type == UapItemType::Extended || it.type == UapItemType::Repetitive) && it.len == 0) {
+        Logger::error("[SPEC] CAT{:03d} I{}: {} item needs a length", cat, itemId, type);
+        return false;
+    }
+    if (it.type == UapItemType::Extended && it.ext == 0) it.ext = 1;
+
+    ItemInfo& info = m_items[index];
+    info.enabled = j.value("decode", true);
+    info.source = (it.id == 10 && it.type == UapItemType::Fixed && it.len == 2);
+    info.firstField = uint32_t(m_fields.size());
+
+    uint32_t bit = 0;
+    for (const auto& f : j.value("fields", json::array())) {
+        int bits = f.value("bits", 0);
+        if (bits <= 0 || bits > MAX_FIELD_BITS) {
+            Logger::error("[SPEC] CAT{:03d} I{}: field width must be 1..{} bits", cat, itemId, MAX_FIELD_BITS);
+            return false;
+        }
+        std::string name = f.value("name", "");
+        if (!name.empty()) {
+            char prefix[16];
+            snprintf(prefix, sizeof(prefix), "%03u_%s_", cat, itemId.c_str());
+            Field field;
+            field.name = uint32_t(m_names.size());
+            field.bitOffset = uint16_t(bit);
+            field.bits = uint8_t(bits);
+            field.isSigned = f.value("signed", false);
+            field.scale = f.value("scale", 1.0);
+            m_names.push_back(prefix + name);
+            m_fields.push_back(field);
+        }
+        bit += uint32_t(bits);
+    }
+    info.fieldCount = uint16_t(m_fields.size() - info.firstField);
+
+    if (it.type == UapItemType::Compound) {
+        // Subfields go at the end of the layout; pointers are fixed up once loading is done
+        const json& subs = j.value("sub", json::array());
+        if (subs.empty() || subs.size() > 255) {
+            Logger::error("[SPEC] CAT{:03d} I{}: compound item needs 1..255 subfields", cat, itemId);
+            return false;
+        }
+        uint32_t first = uint32_t(m_layout.size());
+        m_layout.resize(first + subs.size());
+        m_items.resize(first + subs.size());
+        subIndex.resize(first + subs.size(), UINT32_MAX);
+        subIndex[index] = first;
+        m_layout[index].subCount = uint8_t(subs.size());
+        for (size_t i = 0; i < subs.size(); ++i) {
+            if (!parseItem(subs[i], cat, itemId, first + uint32_t(i), subIndex)) return false;
+        }
+    }
+    return true;
+}
+
+bool UapSpec::load(const std::string& path) {
+    std::fill(std::begin(m_defaultEdition), std::end(m_defaultEdition), int16_t(-1));
+    std::fill(std::begin(m_hasSources), std::end(m_hasSources), false);
+    m_layout.clear(); m_items.clear(); m_fields.clear(); m_names.clear();
+    m_editions.clear(); m_tables.clear(); m_sources.clear();
+
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    json j = json::parse(file, nullptr, false);
+    if (j.is_discarded() || !j.contains("categories")) {
+        Logger::error("[SPEC] Could not parse {}", path);
+        return false;
+    }
+
+    std::vector<uint32_t> subIndex;
+    for (const auto& c : j["categories"]) {
+        int cat = c.value("category", -1);
+        if (cat < 0 || cat > 255) { Logger::error("[SPEC] Invalid category in {}", path); return false; }
+        std::string defaultName = c.value("default_edition", "");
+
+        size_t catFirst = m_editions.size();
+        for (const auto& e : c.value("editions", json::array())) {
+            const json& uap = e.value("uap", json::array());
+            if (uap.empty() || uap.size() > ASTERIX_MAX_FRN) {
+                Logger::error("[SPEC] CAT{:03d}: a UAP needs 1..{} items", cat, ASTERIX_MAX_FRN);
+                return false;
+            }
+
+            Edition ed;
+            ed.category = uint8_t(cat);
+            ed.name = e.value("edition", "");
+            ed.firstItem = uint32_t(m_layout.size());
+            ed.count = uint8_t(uap.size());
+            m_layout.resize(ed.firstItem + ed.count);
+            m_items.resize(ed.firstItem + ed.count);
+            subIndex.resize(ed.firstItem + ed.count, UINT32_MAX);
+
+            for (size_t frn = 0; frn < uap.size(); ++frn) {
+                std::string itemId = uap[frn].value("id", std::to_string(frn + 1));
+                if (!parseItem(uap[frn], uint8_t(cat), itemId, ed.firstItem + uint32_t(frn), subIndex)) return false;
+            }
+            if (ed.name == defaultName || m_defaultEdition[cat] < 0) m_defaultEdition[cat] = int16_t(m_editions.size());
+            m_editions.push_back(ed);
+        }
+        if (m_editions.size() == catFirst) continue;
+
+        for (const auto& s : c.value("sources", json::array())) {
+            std::string name = s.value("edition", "");
+            int found = -1;
+            for (size_t i = catFirst; i < m_editions.size(); ++i) {
+                if (m_editions[i].name == name) found = int(i);
+            }
+            if (found < 0) {
+                Logger::error("[SPEC] CAT{:03d}: source {}/{} names unknown edition '{}'",
+                              cat, s.value("sac", 0), s.value("sic", 0), name);
+                return false;
+            }
+            m_sources.emplace_back(sourceKey(uint8_t(cat), uint8_t(s.value("sac", 0)), uint8_t(s.value("sic", 0))),
+                                   uint16_t(found));
+            m_hasSources[cat] = true;
+        }
+    }
+    std::sort(m_sources.begin(), m_sources.end());
+
+    // The layout no longer grows: resolve compound subfield pointers
+    for (size_t i = 0; i < m_layout.size(); ++i) {
+        if (i < subIndex.size() && subIndex[i] != UINT32_MAX) m_layout[i].sub = &m_layout[subIndex[i]];
+    }
+    for (const auto& ed : m_editions) {
+        m_tables.push_back({ed.category, &m_layout[ed.firstItem], ed.count});
+        Logger::info("[SPEC] CAT{:03d} edition {}: {} items", ed.category, ed.name.empty() ? "-" : ed.name, ed.count);
+    }
+    Logger::info("[SPEC] Loaded {} editions, {} fields, {} source overrides from {}",
+                 m_editions.size(), m_fields.size(), m_sources.size(), path);
+    return !m_editions.empty();
+}
+
+void UapSpec::bindMapping(const AsterixConfigParser& mapping) {
+    bool mentioned[256] = {};
+    for (const auto& m : mapping.allMappings()) mentioned[m.category] = true;
+    mentioned[0] = false;
+    auto wanted = [&mapping](const std::string& name) { return mapping.fieldId(name) >= 0; };
+
+    size_t disabled = 0;
+    for (const auto& ed : m_editions) {
+        if (!mentioned[ed.category]) continue;
+        for (uint32_t i = ed.firstItem; i < ed.firstItem + ed.count; ++i) {
+            ItemInfo& info = m_items[i];
+            if (info.source) continue;
+            bool used = false;
+            for (uint32_t f = 0; f < info.fieldCount && !used; ++f) used = wanted(fieldName(info.firstField + f));
+            // Compound subfields count for their parent item
+            const UapItem& it = m_layout[i];
+            for (uint8_t s = 0; s < it.subCount && !used; ++s) {
+                const ItemInfo& sub = m_items[(it.sub + s) - m_layout.data()];
+                for (uint32_t f = 0; f < sub.fieldCount && !used; ++f) used = wanted(fieldName(sub.firstField + f));
+            }
+            if (!used && info.enabled) { info.enabled = false; disabled++; }
+        }
+    }
+    if (disabled) Logger::info("[SPEC] {} items not named by the mapping file are skipped", disabled);
+}
+
+int UapSpec::sourceEdition(uint8_t cat, uint8_t sac, uint8_t sic) const {
+    if (!m_hasSources[cat]) return -1;
+    uint32_t key = sourceKey(cat, sac, sic);
+    auto it = std::lower_bound(m_sources.begin(), m_sources.end(), std::make_pair(key, uint16_t(0)));
+    return (it != m_sources.end() && it->first == key) ? it->second : -1;
+}
+
+// --- DECODING ---
+void UapSpec::emitFields(uint32_t item, const uint8_t* p, size_t len, AsterixDecodeResult& out) const {
+    const ItemInfo& info = m_items[item];
+    for (uint32_t f = info.firstField; f < info.firstField + info.fieldCount; ++f) {
+        const Field& field = m_fields[f];
+        uint64_t raw;
+        if (!readBits(p, len, field.bitOffset, field.bits, raw)) continue;
+        double v;
+        if (field.isSigned && (raw >> (field.bits - 1)) & 1) v = double(int64_t(raw) - (int64_t(1) << field.bits));
+        else v = double(raw);
+        out.values.push_back({f, v * field.scale});
+    }
+}
+
+void UapSpec::emitItem(uint32_t item, const uint8_t* p, size_t len, AsterixDecodeResult& out) const {
+    const UapItem& it = m_layout[item];
+    switch (it.type) {
+        case UapItemType::Fixed:
+        case UapItemType::Extended:
+            emitFields(item, p, len, out);
+            break;
+        case UapItemType::Repetitive:
+            for (size_t off = 1; off + it.len <= len; off += it.len) emitFields(item, p + off, it.len, out);
+            break;
+        case UapItemType::Explicit:
+            emitFields(item, p + 1, len - 1, out);
+            break;
+        case UapItemType::Compound: {
+            // Same walk as AsterixDecoder::itemLength(), which already validated it
+            const uint8_t* end = p + len;
+            size_t ps = 0;
+            while (p[ps++] & 0x01) {}
+            const uint8_t* q = p + ps;
+            uint32_t first = uint32_t(it.sub - m_layout.data());
+            for (size_t byte = 0; byte < ps; ++byte) {
+                for (int bit = 0; bit < 7; ++bit) {
+                    if (!(p[byte] & (0x80 >> bit))) continue;
+                    uint32_t sub = first + uint32_t(byte * 7 + bit);
+                    size_t sl = AsterixDecoder::itemLength(m_layout[sub], q, end);
+                    if (m_items[sub].fieldCount) emitItem(sub, q, sl, out);
+                    q += sl;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+const uint8_t* UapSpec::decodeRecord(uint8_t cat, const uint8_t* p, const uint8_t* end,
+                                     AsterixDecodeResult& out, int edition) const {
+    RecordItems items;
+    if (edition < 0) edition = m_defaultEdition[cat];
+    if (edition < 0) return nullptr;
+    const uint8_t* next = AsterixDecoder::walkRecord(m_tables[edition], p, end, items);
+    if (!next) return nullptr;
+
+    // Every edition shares I010 at FRN 1, so the default one can read the source
+    const ItemInfo& first = m_items[m_editions[edition].firstItem];
+    bool hasSource = first.source && items.has(1);
+    uint8_t sac = hasSource ? items.at(1)[0] : 0;
+    uint8_t sic = hasSource ? items.at(1)[1] : 0;
+    if (hasSource) {
+        int wanted = sourceEdition(cat, sac, sic);
+        if (wanted >= 0 && wanted != edition) {
+            edition = wanted;
+            next = AsterixDecoder::walkRecord(m_tables[edition], p, end, items);
+            if (!next) return nullptr;
+        }
+    }
+
+    SpecRecord rec;
+    rec.category = cat;
+    rec.edition = uint16_t(edition);
+    rec.hasSource = hasSource;
+    rec.sac = sac;
+    rec.sic = sic;
+    rec.firstValue = uint32_t(out.values.size());
+
+    // Disabled items were only located (by their length rule), never read
+    const Edition& ed = m_editions[edition];
+    for (uint64_t bits = items.present; bits; bits &= bits - 1) {
+        int frn = __builtin_ctzll(bits) + 1;
+        uint32_t index = ed.firstItem + uint32_t(frn - 1);
+        if (!m_items[index].enabled || m_items[index].source) continue;
+        emitItem(index, items.at(frn), items.items[frn - 1].len, out);
+    }
+    rec.valueCount = uint32_t(out.values.size() - rec.firstValue);
+    out.other.push_back(rec);
+    return next;
+}
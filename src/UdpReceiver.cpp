@@ -0,0 +1,157 @@
+#include "UdpReceiver.hpp"
+#include "Logger.hpp"
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <chrono>
+#include <thread>
+
+UdpReceiver::~UdpReceiver() { close(); }
+
+bool UdpReceiver::open(const Options& opts, PacketPool& pool) {
+    close();
+    m_opts = opts;
+    m_pool = &pool;
+    if (m_opts.batchSize < 1) m_opts.batchSize = 1;
+
+    m_sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (m_sock < 0) {
+        Logger::error("[UDP] socket() failed: {}", strerror(errno));
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(m_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (m_opts.reusePort) setsockopt(m_sock, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse));
+
+    struct in_addr group;
+    bool multicast = !m_opts.group.empty() && inet_pton(AF_INET, m_opts.group.c_str(), &group) == 1 &&
+                     IN_MULTICAST(ntohl(group.s_addr));
+
+    // Size the kernel queue so a burst survives while we are busy decoding.
+    // SO_RCVBUFFORCE ignores rmem_max but needs CAP_NET_ADMIN, so try it first.
+    int rcvBuf = m_opts.rcvBufBytes;
+    if (rcvBuf > 0 && setsockopt(m_sock, SOL_SOCKET, SO_RCVBUFFORCE, &rcvBuf, sizeof(rcvBuf)) < 0) {
+        setsockopt(m_sock, SOL_SOCKET, SO_RCVBUF, &rcvBuf, sizeof(rcvBuf));
+    }
+    int actual = 0; socklen_t alen = sizeof(actual);
+    getsockopt(m_sock, SOL_SOCKET, SO_RCVBUF, &actual, &alen);
+    if (rcvBuf > 0 && actual / 2 < rcvBuf) {
+        Logger::warn("[UDP] SO_RCVBUF capped at {} bytes (requested {}). Raise net.core.rmem_max.", actual / 2, rcvBuf);
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(m_opts.port);
+    // A multicast input binds to its group so another input on the same
+    // port does not see this group's traffic
+    addr.sin_addr.s_addr = multicast ? group.s_addr : htonl(INADDR_ANY);
+    if (bind(m_sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        Logger::error("[UDP] Failed to bind UDP port {}: {}", m_opts.port, strerror(errno));
+        close();
+        return false;
+    }
+
+    // Multicast join on the configured interface
+    if (multicast) {
+        int all = 0;
+        setsockopt(m_sock, IPPROTO_IP, IP_MULTICAST_ALL, &all, sizeof(all));
+        struct ip_mreqn mreq;
+        memset(&mreq, 0, sizeof(mreq));
+        mreq.imr_multiaddr = group;
+        mreq.imr_address.s_addr = htonl(INADDR_ANY);
+        if (!m_opts.interface.empty() && m_opts.interface != "any") {
+            mreq.imr_ifindex = if_nametoindex(m_opts.interface.c_str());
+        }
+        if (setsockopt(m_sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+            Logger::error("[UDP] Failed to join {} on {}: {}", m_opts.group, m_opts.interface, strerror(errno));
+        } else {
+            Logger::info("[UDP] Joined multicast group {} on {}", m_opts.group, m_opts.interface);
+        }
+    }
+
+    // Message headers are preallocated; buffers come from the pool per slot
+    m_slots.assign(m_opts.batchSize, PacketRef());
+    m_iovs.assign(m_opts.batchSize, iovec{});
+    m_msgs.assign(m_opts.batchSize, mmsghdr{});
+    m_addrs.assign(m_opts.batchSize, sockaddr_in{});
+
+    Logger::info("[UDP] Listening on port {} (batch {}, {} byte pooled buffers)",
+                 m_opts.port, m_opts.batchSize, m_pool->bufferSize());
+    return true;
+}
+
+void UdpReceiver::close() {
+    if (m_sock != -1) { ::close(m_sock); m_sock = -1; }
+}
+
+int UdpReceiver::receive(int timeoutMs) {
+    if (m_sock == -1) return -1;
+
+    // Refill the slots handed out by the previous batch
+    int slots = 0;
+    for (; slots < m_opts.batchSize; ++slots) {
+        if (!m_slots[slots]) {
+            m_slots[slots] = m_pool->acquire();
+            if (!m_slots[slots]) break;
+        }
+        m_iovs[slots].iov_base = m_slots[slots]->data;
+        m_iovs[slots].iov_len = m_slots[slots]->capacity;
+    }
+    if (slots == 0) {
+        // Pool exhausted: leave the datagrams queued in the kernel for now
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return 0;
+    }
+
+    struct pollfd pfd = {m_sock, POLLIN, 0};
+    int pr = poll(&pfd, 1, timeoutMs);
+    if (pr <= 0) return (pr < 0 && errno != EINTR) ? -1 : 0;
+
+    for (int i = 0; i < slots; ++i) {
+        mmsghdr& m = m_msgs[i];
+        memset(&m.msg_hdr, 0, sizeof(m.msg_hdr));
+        m.msg_hdr.msg_iov = &m_iovs[i];
+        m.msg_hdr.msg_iovlen = 1;
+        m.msg_hdr.msg_name = &m_addrs[i];
+        m.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        m.msg_len = 0;
+    }
+
+    int n = recvmmsg(m_sock, m_msgs.data(), slots, MSG_DONTWAIT, nullptr);
+    if (n < 0) return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    for (int i = 0; i < n; ++i) {
+        PacketBuffer& b = *m_slots[i];
+        b.tsSec = uint32_t(ts.tv_sec);
+        b.tsNsec = uint32_t(ts.tv_nsec);
+        if (m_msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            // Drop: a truncated ASTERIX block cannot be decoded
+            m_truncated++;
+            b.len = b.payloadLen = 0;
+        } else {
+            b.len = b.origLen = b.payloadLen = m_msgs[i].msg_len;
+            b.payloadOff = 0;
+        }
+    }
+    m_datagrams += n;
+    return n;
+}
+
+bool UdpReceiver::setFilter(const AsterixSelect& select) {
+    if (m_sock == -1) return false;
+    if (select.empty()) return BpfFilter::detach(m_sock);
+    return BpfFilter::attach(m_sock, BpfFilter::asterixPayload(select));
+}
+
+PacketRef UdpReceiver::take(int i) {
+    if (!m_slots[i] || m_slots[i]->payloadLen == 0) return PacketRef();
+    return std::move(m_slots[i]);
+}
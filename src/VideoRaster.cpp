@@ -0,0 +1,285 @@
+#include "VideoRaster.hpp"
+#include <zlib.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static constexpr double PI = 3.14159265358979323846;
+static constexpr double SPEED_OF_LIGHT = 299792458.0;
+static constexpr double EARTH_RADIUS_M = 6371000.0;
+static constexpr int TILE = 256;
+
+// Peak of a run of cells: the blend used when several cells fall in one range bin
+static uint8_t maxSpan(const uint8_t* p, size_t n) {
+    uint8_t m = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    if (n >= 16) {
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 16 <= n; i += 16) acc = _mm_max_epu8(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+        acc = _mm_max_epu8(acc, _mm_srli_si128(acc, 8));
+        acc = _mm_max_epu8(acc, _mm_srli_si128(acc, 4));
+        acc = _mm_max_epu8(acc, _mm_srli_si128(acc, 2));
+        acc = _mm_max_epu8(acc, _mm_srli_si128(acc, 1));
+        m = uint8_t(_mm_cvtsi128_si32(acc));
+    }
+#endif
+    for (; i < n; ++i) m = std::max(m, p[i]);
+    return m;
+}
+
+VideoRaster::VideoRaster(int size, int azimuthBins)
+    : m_size(size & ~1), m_radius(m_size / 2), m_azBins(azimuthBins) {
+    m_pixels.assign(size_t(m_size) * m_size, 0);
+    m_row.assign(m_radius, 0);
+    buildLut();
+}
+
+void VideoRaster::buildLut() {
+    // Counting sort of every pixel inside the circle by azimuth bin
+    std::vector<uint32_t> bin(size_t(m_size) * m_size, UINT32_MAX);
+    m_azStart.assign(m_azBins + 1, 0);
+    double c = m_size / 2.0;
+    for (int y = 0; y < m_size; ++y) {
+        for (int x = 0; x < m_size; ++x) {
+            double dx = x + 0.5 - c, dy = c - (y + 0.5);
+            double r = std::hypot(dx, dy);
+            if (r >= m_radius) continue;
+            double az = std::atan2(dx, dy) * 180.0 / PI;
+            if (az < 0) az += 360.0;
+            uint32_t a = uint32_t(az / 360.0 * m_azBins) % uint32_t(m_azBins);
+            bin[size_t(y) * m_size + x] = a;
+            m_azStart[a + 1]++;
+        }
+    }
+    for (int a = 0; a < m_azBins; ++a) m_azStart[a + 1] += m_azStart[a];
+
+    m_lutPixel.assign(m_azStart[m_azBins], 0);
+    m_lutBin.assign(m_azStart[m_azBins], 0);
+    std::vector<uint32_t> fill(m_azStart.begin(), m_azStart.end() - 1);
+    for (int y = 0; y < m_size; ++y) {
+        for (int x = 0; x < m_size; ++x) {
+            uint32_t a = bin[size_t(y) * m_size + x];
+            if (a == UINT32_MAX) continue;
+            double dx = x + 0.5 - c, dy = c - (y + 0.5);
+            uint32_t k = fill[a]++;
+            m_lutPixel[k] = uint32_t(y) * m_size + x;
+            m_lutBin[k] = uint16_t(std::min<int>(int(std::hypot(dx, dy)), m_radius - 1));
+        }
+    }
+}
+
+void VideoRaster::setRange(double rangeM) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (rangeM <= 0 || rangeM == m_rangeM) return;
+    m_rangeM = rangeM;
+    std::fill(m_pixels.begin(), m_pixels.end(), 0);
+}
+
+void VideoRaster::setOrigin(uint8_t sac, uint8_t sic, double lat, double lon) {
+    uint16_t source = uint16_t(sac << 8 | sic);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_sites.begin(), m_sites.end(), [source](const Site& s) { return s.source == source; });
+    if (it == m_sites.end()) m_sites.push_back({source, lat, lon});
+    else { it->lat = lat; it->lon = lon; }
+    if (m_source == source) { m_lat = lat; m_lon = lon; m_hasOrigin = true; }
+}
+
+bool VideoRaster::hasOrigin() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hasOrigin;
+}
+
+VideoRaster::Stats VideoRaster::stats() const {
+    Stats s;
+    s.messages = m_messages.load(std::memory_order_relaxed);
+    s.cells = m_cellCount.load(std::memory_order_relaxed);
+    s.rejected = m_rejected.load(std::memory_order_relaxed);
+    s.otherSource = m_otherSource.load(std::memory_order_relaxed);
+    return s;
+}
+
+size_t VideoRaster::expandCells(const Cat240Record& r, const uint8_t*& cells) {
+    const uint8_t* data = r.cells;
+    size_t octets = r.validOctets ? std::min<size_t>(r.validOctets, r.cellBytes) : r.cellBytes;
+    size_t bits = r.bitsPerCell;
+    size_t count = std::min<size_t>(r.cellCount, bits ? octets * 8 / bits : 0);
+    if (count == 0) return 0;
+
+    // I048 C bit: the video blocks hold a zlib stream of the cell octets
+    if (r.compressed) {
+        uLongf out = uLongf((size_t(r.cellCount) * bits + 7) / 8);
+        if (m_inflated.size() < out) m_inflated.resize(out);
+        if (uncompress(m_inflated.data(), &out, r.cells, uLong(octets)) != Z_OK) return 0;
+        data = m_inflated.data();
+        count = std::min<size_t>(r.cellCount, size_t(out) * 8 / bits);
+        if (count == 0) return 0;
+    }
+
+    if (bits == 8) { cells = data; return count; }
+
+    if (m_cells.size() < count) m_cells.resize(count);
+    uint8_t* out = m_cells.data();
+    switch (bits) {
+        case 1: for (size_t i = 0; i < count; ++i) out[i] = ((data[i >> 3] >> (7 - (i & 7))) & 0x01) * 255; break;
+        case 2: for (size_t i = 0; i < count; ++i) out[i] = ((data[i >> 2] >> (6 - 2 * (i & 3))) & 0x03) * 85; break;
+        case 4: for (size_t i = 0; i < count; ++i) out[i] = ((data[i >> 1] >> (4 - 4 * (i & 1))) & 0x0F) * 17; break;
+        // Wider cells keep their most significant octet
+        case 16: for (size_t i = 0; i < count; ++i) out[i] = data[i * 2]; break;
+        case 32: for (size_t i = 0; i < count; ++i) out[i] = data[i * 4]; break;
+        default: return 0;
+    }
+    cells = out;
+    return count;
+}
+
+void VideoRaster::resampleRow(const Cat240Record& r, const uint8_t* cells, size_t count, double rangeM) {
+    // Cell k spans [(startRange + k) * cellM, (startRange + k + 1) * cellM)
+    double cellM = r.cellDuration * SPEED_OF_LIGHT / 2.0;
+    double binM = rangeM / m_radius;
+    double cellsPerBin = binM / cellM;
+    double first = double(r.startRange);
+
+    auto cellAt = [&](int b) {
+        double k = std::ceil(b * cellsPerBin - first);
+        return size_t(std::clamp(k, 0.0, double(count)));
+    };
+    size_t c0 = cellAt(0);
+    for (int b = 0; b < m_radius; ++b) {
+        size_t c1 = cellAt(b + 1);
+        if (c1 > c0) {
+            m_row[b] = maxSpan(cells + c0, c1 - c0);
+        } else {
+            // Cells coarser than the raster: nearest cell
+            double k = std::floor((b + 0.5) * cellsPerBin - first);
+            m_row[b] = (k >= 0 && k < double(count)) ? cells[size_t(k)] : 0;
+        }
+        c0 = c1;
+    }
+}
+
+bool VideoRaster::update(const Cat240Record& r) {
+    const uint32_t needed = C240_HEADER | C240_RESOLUTION | C240_CELL_COUNT | C240_CELLS;
+    if (r.messageType != 2 || (r.present & needed) != needed || r.cellDuration <= 0) return false;
+
+    // Bind to the first radar seen, placed at its site if that is already known
+    int source = (r.present & C240_DATA_SOURCE) ? (r.sac << 8 | r.sic) : 0;
+    double rangeM;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_source < 0) {
+            m_source = source;
+            for (const auto& s : m_sites) {
+                if (s.source == source) { m_lat = s.lat; m_lon = s.lon; m_hasOrigin = true; }
+            }
+        }
+        if (source != m_source) {
+            m_otherSource.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        rangeM = m_rangeM;
+    }
+
+    const uint8_t* cells = nullptr;
+    size_t count = expandCells(r, cells);
+    if (count == 0) {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    resampleRow(r, cells, count, rangeM);
+
+    // Azimuth bins swept by this message, wrapping through north
+    int a0 = int(r.startAz / 360.0 * m_azBins) % m_azBins;
+    int a1 = int(r.endAz / 360.0 * m_azBins) % m_azBins;
+    int span = (a1 - a0 + m_azBins) % m_azBins + 1;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint8_t* pixels = m_pixels.data();
+    const uint8_t* row = m_row.data();
+    for (int i = 0; i < span; ++i) {
+        int a = (a0 + i) % m_azBins;
+        for (uint32_t k = m_azStart[a]; k < m_azStart[a + 1]; ++k) pixels[m_lutPixel[k]] = row[m_lutBin[k]];
+    }
+    m_messages.fetch_add(1, std::memory_order_relaxed);
+    m_cellCount.fetch_add(count, std::memory_order_relaxed);
+    return true;
+}
+
+static void pngChunk(std::string& out, const char* type, const uint8_t* data, size_t len) {
+    uint8_t hdr[8] = {uint8_t(len >> 24), uint8_t(len >> 16), uint8_t(len >> 8), uint8_t(len),
+                      uint8_t(type[0]), uint8_t(type[1]), uint8_t(type[2]), uint8_t(type[3])};
+    out.append(reinterpret_cast<const char*>(hdr), 8);
+    if (len) out.append(reinterpret_cast<const char*>(data), len);
+    uLong crc = crc32(0, hdr + 4, 4);
+    if (len) crc = crc32(crc, data, uInt(len));
+    uint8_t c[4] = {uint8_t(crc >> 24), uint8_t(crc >> 16), uint8_t(crc >> 8), uint8_t(crc)};
+    out.append(reinterpret_cast<const char*>(c), 4);
+}
+
+void VideoRaster::encodePng(const std::vector<uint8_t>& rgba, int w, int h, std::string& out) {
+    static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    out.assign(reinterpret_cast<const char*>(SIGNATURE), 8);
+
+    uint8_t ihdr[13] = {uint8_t(w >> 24), uint8_t(w >> 16), uint8_t(w >> 8), uint8_t(w),
+                        uint8_t(h >> 24), uint8_t(h >> 16), uint8_t(h >> 8), uint8_t(h),
+                        8, 6, 0, 0, 0};   // 8-bit RGBA, no interlace
+    pngChunk(out, "IHDR", ihdr, sizeof(ihdr));
+
+    // Filter type 0 on every scanline
+    size_t stride = size_t(w) * 4;
+    std::vector<uint8_t> raw((stride + 1) * h);
+    for (int y = 0; y < h; ++y) {
+        raw[y * (stride + 1)] = 0;
+        memcpy(&raw[y * (stride + 1) + 1], &rgba[y * stride], stride);
+    }
+    uLongf zlen = compressBound(uLong(raw.size()));
+    std::vector<uint8_t> z(zlen);
+    compress2(z.data(), &zlen, raw.data(), uLong(raw.size()), Z_BEST_SPEED);
+    pngChunk(out, "IDAT", z.data(), zlen);
+    pngChunk(out, "IEND", nullptr, 0);
+}
+
+bool VideoRaster::tilePng(int z, int x, int y, std::string& png) const {
+    if (z < 0 || z > 24) return false;
+    double n = double(1u << z);
+    std::vector<uint8_t> intensity(TILE * TILE, 0);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hasOrigin) return false;
+
+        // Local equirectangular projection about the sensor, in raster pixels
+        double pxPerM = m_radius / m_rangeM;
+        double mPerDegLat = EARTH_RADIUS_M * PI / 180.0;
+        double mPerDegLon = mPerDegLat * std::cos(m_lat * PI / 180.0);
+        double c = m_size / 2.0;
+
+        std::vector<int> col(TILE, -1);
+        for (int i = 0; i < TILE; ++i) {
+            double lon = (x + (i + 0.5) / TILE) / n * 360.0 - 180.0;
+            double px = c + (lon - m_lon) * mPerDegLon * pxPerM;
+            if (px >= 0 && px < m_size) col[i] = int(px);
+        }
+        for (int j = 0; j < TILE; ++j) {
+            double lat = std::atan(std::sinh(PI * (1.0 - 2.0 * (y + (j + 0.5) / TILE) / n))) * 180.0 / PI;
+            double py = c - (lat - m_lat) * mPerDegLat * pxPerM;
+            if (py < 0 || py >= m_size) continue;
+            const uint8_t* src = &m_pixels[size_t(py) * m_size];
+            for (int i = 0; i < TILE; ++i) {
+                if (col[i] >= 0) intensity[j * TILE + i] = src[col[i]];
+            }
+        }
+    }
+
+    // Green echoes, opacity following the echo strength
+    std::vector<uint8_t> rgba(size_t(TILE) * TILE * 4, 0);
+    for (size_t i = 0; i < intensity.size(); ++i) {
+        if (!intensity[i]) continue;
+        rgba[i * 4 + 1] = 255;
+        rgba[i * 4 + 3] = intensity[i];
+    }
+    encodePng(rgba, TILE, TILE, png);
+    return true;
+}
@@ -0,0 +1,75 @@
+#include "WebFeed.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+WebFeed::WebFeed(size_t capacity) : m_ring(capacity ? capacity : 1), m_snapshot(m_ring.size()) {}
+
+void WebFeed::push(const WebRecord& r) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t cap = m_ring.size();
+    if (m_count == cap) {
+        m_ring[m_head] = r;
+        m_head = (m_head + 1) % cap;
+        m_overwritten++;
+        return;
+    }
+    m_ring[(m_head + m_count) % cap] = r;
+    m_count++;
+}
+
+uint64_t WebFeed::overwritten() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_overwritten;
+}
+
+size_t WebFeed::drain(std::string& out) {
+    std::lock_guard<std::mutex> drainLock(m_drainMutex);
+    size_t n;
+    {
+        // Copy out (at most two runs) so formatting never holds up push()
+        std::lock_guard<std::mutex> lock(m_mutex);
+        n = m_count;
+        size_t cap = m_ring.size();
+        size_t first = std::min(n, cap - m_head);
+        memcpy(m_snapshot.data(), &m_ring[m_head], first * sizeof(WebRecord));
+        memcpy(m_snapshot.data() + first, m_ring.data(), (n - first) * sizeof(WebRecord));
+        m_head = m_count = 0;
+    }
+
+    out.clear();
+    out += '[';
+    for (size_t i = 0; i < n; ++i) {
+        if (i) out += ',';
+        append(m_snapshot[i], out);
+    }
+    out += ']';
+    return n;
+}
+
+// --- SERIALIZATION ---
+// Ids and callsigns are digits, hex and the ICAO character set: no escaping needed
+void WebFeed::append(const WebRecord& r, std::string& out) {
+    char buf[160];
+    int len = snprintf(buf, sizeof(buf), "{\"cat\":%u", unsigned(r.category));
+    out.append(buf, len);
+    if (r.flags & WEB_SOURCE) { len = snprintf(buf, sizeof(buf), ",\"sac\":%u,\"sic\":%u", unsigned(r.sac), unsigned(r.sic)); out.append(buf, len); }
+    if (r.flags & WEB_TIME) { len = snprintf(buf, sizeof(buf), ",\"tod\":%.3f", r.timeOfDay); out.append(buf, len); }
+    if (r.id[0]) { out += ",\"id\":\""; out += r.id; out += '"'; }
+    if (r.uid[0]) { out += ",\"uid\":\""; out += r.uid; out += '"'; }
+    if (r.flags & WEB_DROPPED) out += ",\"drop\":1";
+    if (r.callsign[0]) { out += ",\"cs\":\""; out += r.callsign; out += '"'; }
+    if (r.flags & WEB_GEO) { len = snprintf(buf, sizeof(buf), ",\"lat\":%.6f,\"lon\":%.6f", r.lat, r.lon); out.append(buf, len); }
+    if (r.flags & WEB_POLAR) { len = snprintf(buf, sizeof(buf), ",\"rho\":%.4f,\"theta\":%.4f", r.rho, r.theta); out.append(buf, len); }
+    if (r.flags & WEB_VELOCITY) { len = snprintf(buf, sizeof(buf), ",\"spd\":%.2f,\"hdg\":%.2f", r.speed, r.heading); out.append(buf, len); }
+    if (r.flags & WEB_FLIGHT_LEVEL) { len = snprintf(buf, sizeof(buf), ",\"fl\":%.2f", r.flightLevel); out.append(buf, len); }
+    if (r.extraCount > 0) {
+        out += ",\"x\":{";
+        for (int i = 0; i < r.extraCount && i < WebRecord::MAX_EXTRAS; ++i) {
+            len = snprintf(buf, sizeof(buf), "%s\"%.64s\":%.6g", i ? "," : "", r.extras[i].name, r.extras[i].value);
+            out.append(buf, len);
+        }
+        out += '}';
+    }
+    out += '}';
+}
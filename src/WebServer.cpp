@@ -1,5 +1,6 @@
 #include "WebServer.hpp"
 #include "Logger.hpp"
+#include "ModeS.hpp"
 #include <fstream>
 #include <sstream>
 #include <dirent.h> 
@@ -165,10 +166,15 @@ void WebServer::setupRoutes() {
             }
 
             // --- STEP 3: CONVERT ---
-            std::string finalOutput = "output/export_" + timestamp + "." + format;
+            std::string finalOutput = "output/export_" + timestamp + "." + (format == "json" ? "json" : "csv");
             std::string convertCmd = "";
+            int ret = 0;
 
-            if (format == "json") {
+            if (format == "modes") {
+                // Mode S Comm-B registers: tshark does not decode I250, so this is a native pass
+                ret = exportModeSCsv(sourcePcap, finalOutput) ? 0 : 1;
+            }
+            else if (format == "json") {
                 // JSON export
                 convertCmd = "tshark -r " + sourcePcap + " -T json > " + finalOutput;
             } 
@@ -250,7 +256,7 @@ void WebServer::setupRoutes() {
             }
 
             // Logger::info("Converting file: {}", convertCmd);
-            int ret = system(convertCmd.c_str());
+            if (!convertCmd.empty()) ret = system(convertCmd.c_str());
 
             // Cleanup
             if (createdTempPcap) {
@@ -317,6 +323,7 @@ void WebServer::setupRoutes() {
     // 3. CONFIG
     m_server.Get("/api/config", [&](const httplib::Request& req, httplib::Response& res) {
         nlohmann::json j = m_config; // Uses the INTRUSIVE macro from AppConfig.hpp
+        j["allowed_sources"] = ConfigLoader::sourcesToJson(m_config.allowed_sources);
         res.set_content(j.dump(), "application/json");
     });
 
@@ -326,18 +333,42 @@ void WebServer::setupRoutes() {
     m_server.Post("/api/config", [&](const httplib::Request& req, httplib::Response& res) {
         try {
             auto x = nlohmann::json::parse(req.body);
+
+            // Filter first: a rejected one leaves every setting untouched
+            if(x.contains("active_categories") || x.contains("allowed_sources")) {
+                AsterixSelect select;
+                nlohmann::json processing;
+                processing["active_categories"] = x.value("active_categories", m_config.active_categories);
+                processing["allowed_sources"] = x.contains("allowed_sources") ? x["allowed_sources"]
+                                                                               : ConfigLoader::sourcesToJson(m_config.allowed_sources);
+                if (!ConfigLoader::parseSelect(processing, select)) {
+                    res.status = 400;
+                    res.set_content(R"({"error":"allowed_sources is longer than the filter can hold"})", "application/json");
+                    return;
+                }
+                // Swapped in the kernel immediately; kept in the config only if every socket took it
+                if (!m_engine.applyFilter(select)) {
+                    res.status = 500;
+                    res.set_content(R"({"error":"the capture filter could not be applied"})", "application/json");
+                    return;
+                }
+            }
             
             // 1. UPDATE INTERNAL MEMORY (Flat)
-            if(x.contains("rx_port")) m_config.rx_port = x["rx_port"].get<int>();
+            if(x.contains("rx_port")) {
+                m_config.rx_port = x["rx_port"].get<int>();
+                if (!m_config.inputs.empty()) m_config.inputs[0].port = m_config.rx_port;
+            }
             if(x.contains("cot_ip")) m_config.cot_ip = x["cot_ip"].get<std::string>(); 
             if(x.contains("cot_port")) m_config.cot_port = x["cot_port"].get<int>(); 
             if(x.contains("cot_proto")) m_config.cot_protocol = x["cot_proto"].get<std::string>();
             if(x.contains("send_sensor_pos")) m_config.send_sensor_pos = x["send_sensor_pos"].get<bool>();
             if(x.contains("tak_output_enabled")) m_config.send_tak_tracks = x["tak_output_enabled"].get<bool>();
+            if(x.contains("tick_rate_ms")) m_config.tick_rate_ms = x["tick_rate_ms"].get<int>();
             if(x.contains("asterix_output_enabled")) m_config.send_asterix = x["asterix_output_enabled"].get<bool>();
             if(x.contains("asterix_ip")) m_config.asterix_ip = x["asterix_ip"].get<std::string>();
             if(x.contains("asterix_port")) m_config.asterix_port = x["asterix_port"].get<int>();
-            
+            if(x.contains("decoder_mode")) m_config.decoder_mode = x["decoder_mode"].get<std::string>(); // Applied on restart
             if(x.contains("ssl_client_pass")) m_config.ssl_client_pass = x["ssl_client_pass"].get<std::string>();
             if(x.contains("ssl_trust_pass")) m_config.ssl_trust_pass = x["ssl_trust_pass"].get<std::string>();
             if(x.contains("ssl_client_cert")) m_config.ssl_client_cert = x["ssl_client_cert"].get<std::string>();
@@ -350,13 +381,45 @@ void WebServer::setupRoutes() {
             root["system"]["app_name"] = "TARGEX-CLI";
             root["system"]["version"] = "1.0.0";
             root["system"]["webport"] = m_config.rx_port_web;
+            root["system"]["tick_rate_ms"] = m_config.tick_rate_ms;
             root["system"]["isMapActive"] = true;
 
             // Network Input
             root["network_input"]["interface"] = m_config.interface;
             root["network_input"]["port"] = m_config.rx_port;
             root["network_input"]["protocol"] = "udp"; // Hardcoded for now
+            root["network_input"]["decoder"] = m_config.decoder_mode;
+            root["network_input"]["multicast_group"] = m_config.multicast_group;
+            root["network_input"]["batch_size"] = m_config.recv_batch_size;
+            root["network_input"]["buffer_count"] = m_config.recv_buffer_count;
+            root["network_input"]["buffer_size"] = m_config.recv_buffer_size;
+            root["network_input"]["socket_buffer"] = m_config.recv_socket_buffer;
+            root["network_input"]["capture"] = m_config.capture_mode;
+            root["network_input"]["ring_block_size"] = m_config.ring_block_size;
+            root["network_input"]["ring_block_count"] = m_config.ring_block_count;
+            root["network_input"]["promiscuous"] = m_config.promiscuous;
+            root["network_input"]["tshark_workers"] = m_config.tshark_workers;
+            root["network_input"]["tshark_dispatch"] = m_config.tshark_dispatch;
+            if (m_config.inputs.size() > 1) {
+                for (const auto& in : m_config.inputs) {
+                    nlohmann::json item;
+                    item["interface"] = in.interface;
+                    item["port"] = in.port;
+                    item["multicast_group"] = in.group;
+                    item["label"] = in.label;
+                    root["network_input"]["inputs"].push_back(item);
+                }
+            }
             
+            // Processing
+            root["processing"]["active_categories"] = m_config.active_categories;
+            root["processing"]["allowed_sources"] = ConfigLoader::sourcesToJson(m_config.allowed_sources);
+
+            // Radar video
+            root["video"]["enabled"] = m_config.video_enabled;
+            root["video"]["range_nm"] = m_config.video_range_nm;
+            root["video"]["raster_size"] = m_config.video_raster_size;
+
             // Asterix
             root["AsterixOutput"]["asterix_ip"] = m_config.asterix_ip;
             root["AsterixOutput"]["asterix_port"] = m_config.asterix_port;
@@ -387,9 +450,23 @@ void WebServer::setupRoutes() {
 
     // 4. DATA
     m_server.Get("/api/data", [&](const httplib::Request& req, httplib::Response& res) {
-        auto batch = m_engine.pollData();
-        nlohmann::json jBatch = batch; 
-        res.set_content(jBatch.dump(), "application/json");
+        // Reused per server thread; the response body is the only copy made
+        thread_local std::string body;
+        m_engine.pollData(body);
+        res.set_content(body.data(), body.size(), "application/json");
+    });
+
+    // Track picture export: ?format=csv downloads it as a file
+    m_server.Get("/api/tracks", [&](const httplib::Request& req, httplib::Response& res) {
+        bool csv = req.has_param("format") && req.get_param_value("format") == "csv";
+        std::string body;
+        m_engine.exportTracks(body, csv);
+        if (csv) {
+            res.set_content(body, "text/csv");
+            res.set_header("Content-Disposition", "attachment; filename=\"tracks.csv\"");
+        } else {
+            res.set_content(body, "application/json");
+        }
     });
 
     // 5. STATUS
@@ -397,9 +474,43 @@ void WebServer::setupRoutes() {
         nlohmann::json status;
         status["tcp_connected"] = m_engine.isTcpConnected();
         status["protocol"] = m_config.cot_protocol; 
+
+        auto pool = m_engine.poolStats();
+        status["packet_pool"]["capacity"] = pool.capacity;
+        status["packet_pool"]["in_use"] = pool.inUse;
+        status["packet_pool"]["high_water"] = pool.highWater;
+        status["packet_pool"]["exhausted"] = pool.exhausted;
+        status["packet_pool"]["buffer_size"] = pool.bufferSize;
+        for (const auto& in : m_engine.inputStats()) {
+            nlohmann::json item;
+            item["label"] = in.label;
+            item["datagrams"] = in.datagrams;
+            item["truncated"] = in.truncated;
+            status["inputs"].push_back(item);
+        }
+        status["mlat"] = m_engine.mlatStatus();
+        if (m_config.video_enabled) {
+            auto video = m_engine.videoStats();
+            status["video"]["messages"] = video.messages;
+            status["video"]["cells"] = video.cells;
+            status["video"]["rejected"] = video.rejected;
+            status["video"]["other_source"] = video.otherSource;
+            status["video"]["has_origin"] = m_engine.videoHasOrigin();
+        }
         res.set_content(status.dump(), "application/json");
     });
 
+    // Radar video PPI as web map tiles (204 until the sensor position is known)
+    m_server.Get(R"(/api/video/(\d+)/(\d+)/(\d+)\.png)", [&](const httplib::Request& req, httplib::Response& res) {
+        std::string png;
+        if (!m_engine.videoTile(std::stoi(req.matches[1]), std::stoi(req.matches[2]), std::stoi(req.matches[3]), png)) {
+            res.status = 204;
+            return;
+        }
+        res.set_header("Cache-Control", "no-store");
+        res.set_content(png, "image/png");
+    });
+
     // 6. UPLOAD (RAW BINARY MODE) - [FIXED]
     m_server.Post("/api/upload", [&](const httplib::Request& req, httplib::Response& res) {
         // Filename passed via URL: /api/upload?name=client.p12
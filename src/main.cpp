@@ -8,6 +8,7 @@
 #include <iomanip>
 #include <sstream>
 #include <fstream> 
+#include <algorithm>
 #include <nlohmann/json.hpp> 
 
 #include "TargexCore.hpp"
@@ -15,6 +16,7 @@
 #include "ConfigLoader.hpp"
 #include "WebServer.hpp"
 #include "MarsEngine.hpp"
+#include "PacketRing.hpp"
 
 std::atomic<bool> keepRunning(true);
 
@@ -52,8 +54,27 @@ int main(int argc, char* argv[]) {
             if (j.contains("network_input")) {
                 if(j["network_input"].contains("interface")) config.interface = j["network_input"]["interface"];
                 if(j["network_input"].contains("port")) config.rx_port = j["network_input"]["port"];
+                if(j["network_input"].contains("multicast_group")) config.multicast_group = j["network_input"]["multicast_group"];
+                if(j["network_input"].contains("decoder")) config.decoder_mode = j["network_input"]["decoder"];
+                if(j["network_input"].contains("batch_size")) config.recv_batch_size = j["network_input"]["batch_size"];
+                if(j["network_input"].contains("buffer_count")) config.recv_buffer_count = j["network_input"]["buffer_count"];
+                if(j["network_input"].contains("buffer_size")) config.recv_buffer_size = j["network_input"]["buffer_size"];
+                if(j["network_input"].contains("socket_buffer")) config.recv_socket_buffer = j["network_input"]["socket_buffer"];
+                if(j["network_input"].contains("capture")) config.capture_mode = j["network_input"]["capture"];
+                if(j["network_input"].contains("ring_block_size")) config.ring_block_size = j["network_input"]["ring_block_size"];
+                if(j["network_input"].contains("ring_block_count")) config.ring_block_count = j["network_input"]["ring_block_count"];
+                if(j["network_input"].contains("promiscuous")) config.promiscuous = j["network_input"]["promiscuous"];
+                if(j["network_input"].contains("tshark_workers")) config.tshark_workers = j["network_input"]["tshark_workers"];
+                if(j["network_input"].contains("tshark_dispatch")) config.tshark_dispatch = j["network_input"]["tshark_dispatch"];
+                ConfigLoader::parseInputs(j["network_input"], config);
             }
 
+            // PROCESSING (kernel-side category / source filter)
+            if (j.contains("processing") && !ConfigLoader::parseProcessing(j["processing"], config)) {
+                Logger::error("processing section rejected; no category/source filter is applied");
+            }
+            if (j.contains("video")) ConfigLoader::parseVideo(j["video"], config);
+
             // 3. TAK OUTPUT
             if (j.contains("TAKOutput")) {
                 auto& tak = j["TAKOutput"];
@@ -94,6 +115,10 @@ int main(int argc, char* argv[]) {
         config.interface = "any";
         Logger::warn("Interface not defined. Defaulting to 'any'.");
     }
+    if (config.inputs.empty()) ConfigLoader::parseInputs(nlohmann::json::object(), config);
+    for (auto& in : config.inputs) {
+        if (in.interface.empty()) in.interface = config.interface;
+    }
 
     // Logger Init
     auto now = std::time(nullptr);
@@ -104,12 +129,31 @@ int main(int argc, char* argv[]) {
 
     Logger::info("TARGEX Server Starting...");
     Logger::info("Capture Interface: {}", config.interface);
-    Logger::info("Listening on UDP Port: {}", config.rx_port);
+    for (const auto& in : config.inputs) {
+        Logger::info("Input '{}': {} UDP {}{}", in.label, in.interface, in.port, in.group.empty() ? "" : " group " + in.group);
+    }
+    Logger::info("ASTERIX Decoder: {}", config.decoder_mode);
 
     // Create Core Systems
+    // Every received packet lives in one pooled buffer shared by all consumers
+    PacketPool packetPool(size_t(std::max(config.recv_buffer_count, 64)), uint32_t(std::max(config.recv_buffer_size, 2048)));
+
     TargexCore engine(config); 
-    MarsEngine processor(config);
+    MarsEngine processor(config, packetPool);
     WebServer webServer(config, processor);
+
+    // One kernel capture shared by the recorder and the decoder
+    PacketRing capture(config, packetPool);
+    bool useRing = false;
+    if (config.capture_mode == "ring") {
+        useRing = capture.open();
+        if (useRing) {
+            engine.attachRing(&capture);
+            processor.attachRing(&capture);
+        } else {
+            Logger::warn("Capture ring unavailable. Falling back to dumpcap + socket input.");
+        }
+    }
     
     try {
         if (!engine.initialize()) {
@@ -121,6 +165,7 @@ int main(int argc, char* argv[]) {
         engine.startCapture();
         processor.start();
         webServer.start(); 
+        if (useRing) capture.start();
 
         Logger::info("System Ready. Web Interface available at http://localhost:{}", config.rx_port_web);
         
@@ -141,6 +186,7 @@ int main(int argc, char* argv[]) {
     webServer.stop();
     processor.stop(); 
     engine.stopCapture();
+    capture.stop();
     
     Logger::info("TARGEX Server stopped gracefully.");
     return 0;